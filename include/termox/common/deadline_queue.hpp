@@ -0,0 +1,126 @@
+#ifndef CATERM_COMMON_DEADLINE_QUEUE_HPP
+#define CATERM_COMMON_DEADLINE_QUEUE_HPP
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ox {
+
+/// Return the deadline that follows \p deadline for a timer with \p interval.
+/** Stays on the schedule set by the first deadline, so the error of each wake
+ *  up does not add up. If \p now is already past that, the missed ticks are
+ *  dropped rather than fired in a burst, and it is one \p interval from now.
+ *  \p interval must be greater than zero. */
+template <typename Time_point, typename Duration>
+[[nodiscard]] auto next_deadline(Time_point deadline,
+                                 Duration interval,
+                                 Time_point now) -> Time_point
+{
+    auto const next = deadline + interval;
+    return next > now ? next : now + interval;
+}
+
+/// Min-heap of values keyed on a deadline, the earliest deadline is on top.
+/** push() and pop() are O(log n). There is no removal of a single value, users
+ *  store an id with each value and drop popped values that are out of date.
+ *  Once those outnumber the rest, erase_if() drops them all in O(n). */
+template <typename T>
+class Deadline_queue {
+   public:
+    using Clock_t    = std::chrono::steady_clock;
+    using Time_point = Clock_t::time_point;
+
+    struct Entry {
+        Time_point deadline;
+        T value;
+    };
+
+   public:
+    /// Returns a const reference to the Entry with the earliest deadline.
+    [[nodiscard]] auto top() const -> Entry const& { return heap_.front(); }
+
+    /// Returns true if no elements in queue.
+    [[nodiscard]] auto is_empty() const -> bool { return heap_.empty(); }
+
+    /// Returns the number of elements currently in the queue.
+    [[nodiscard]] auto size() const -> std::size_t { return heap_.size(); }
+
+    /// Move \p value into the queue to be due at \p deadline.
+    void push(Time_point deadline, T value)
+    {
+        heap_.push_back(Entry{deadline, std::move(value)});
+        std::push_heap(std::begin(heap_), std::end(heap_), Later{});
+    }
+
+    /// Moves top Entry from the queue and returns it, shrinking the queue.
+    auto pop() -> Entry
+    {
+        std::pop_heap(std::begin(heap_), std::end(heap_), Later{});
+        auto result = std::move(heap_.back());
+        heap_.pop_back();
+        return result;
+    }
+
+    /// Remove every Entry.
+    void clear() { heap_.clear(); }
+
+    /// Remove each Entry whose value \p pred returns true for.
+    template <typename Pred>
+    void erase_if(Pred&& pred)
+    {
+        auto const is_erased = [&pred](Entry const& e) {
+            return pred(std::as_const(e.value));
+        };
+        auto const end = std::end(heap_);
+        heap_.erase(std::remove_if(std::begin(heap_), end, is_erased), end);
+        std::make_heap(std::begin(heap_), std::end(heap_), Later{});
+    }
+
+    /// Pop each Entry due by \p now, and pass its value to \p fire.
+    /** \p fire returns the interval to the value's next deadline, the value
+     *  is pushed back on the schedule given by next_deadline(). Or it returns
+     *  nullopt and the value is dropped. Only the Entries that are due are
+     *  visited. */
+    template <typename F>
+    void fire_due(Time_point now, F&& fire)
+    {
+        while (!heap_.empty() && heap_.front().deadline <= now) {
+            auto [deadline, value] = this->pop();
+            if (auto const interval = fire(std::as_const(value))) {
+                this->push(next_deadline(deadline, *interval, now),
+                           std::move(value));
+            }
+        }
+    }
+
+    /// Return the time from \p now to the earliest deadline, up to \p limit.
+    /** Rounded up, so waiting this long reaches the deadline. */
+    template <typename Duration>
+    [[nodiscard]] auto time_until_next(Time_point now, Duration limit) const
+        -> Duration
+    {
+        if (heap_.empty())
+            return limit;
+        auto const left = heap_.front().deadline - now;
+        return std::clamp(std::chrono::ceil<Duration>(left), Duration::zero(),
+                          limit);
+    }
+
+   private:
+    struct Later {
+        [[nodiscard]] auto operator()(Entry const& x, Entry const& y) const
+            -> bool
+        {
+            return x.deadline > y.deadline;
+        }
+    };
+
+    std::vector<Entry> heap_;  // Ordered by std::push_heap() with Later.
+};
+
+}  // namespace ox
+#endif  // CATERM_COMMON_DEADLINE_QUEUE_HPP
@@ -0,0 +1,97 @@
+#ifndef CATERM_COMMON_MPSC_QUEUE_HPP
+#define CATERM_COMMON_MPSC_QUEUE_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace ox {
+
+/// Bounded lock free queue, many threads may push while one thread pops.
+/** A ring of Capacity slots, each with a sequence number that tells producers
+ *  and the consumer whose turn it is to use the slot. Producers claim a slot
+ *  with a single compare and swap, the consumer never writes to shared state
+ *  other than the slot it just read. Capacity must be a power of two. */
+template <typename T, std::size_t Capacity>
+class Mpsc_queue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Mpsc_queue: Capacity must be a power of two.");
+
+   public:
+    Mpsc_queue() : slots_{std::make_unique<Slot[]>(Capacity)}
+    {
+        for (auto i = std::size_t{0}; i < Capacity; ++i)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    Mpsc_queue(Mpsc_queue const&) = delete;
+    Mpsc_queue(Mpsc_queue&&)      = delete;
+    auto operator=(Mpsc_queue const&) -> Mpsc_queue& = delete;
+    auto operator=(Mpsc_queue&&) -> Mpsc_queue& = delete;
+
+   public:
+    /// Append \p value, return false if the queue is full.
+    /** Safe to call from any number of threads at once. \p value is only moved
+     *  from if true is returned. */
+    [[nodiscard]] auto try_push(T&& value) -> bool
+    {
+        auto position = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            auto& slot          = slots_[position & mask];
+            auto const sequence = slot.sequence.load(std::memory_order_acquire);
+            auto const lag      = static_cast<std::intptr_t>(sequence) -
+                             static_cast<std::intptr_t>(position);
+            if (lag < 0)
+                return false;  // The consumer has not emptied this slot yet.
+            if (lag > 0) {
+                position = tail_.load(std::memory_order_relaxed);
+                continue;  // Another producer claimed it first.
+            }
+            if (tail_.compare_exchange_weak(position, position + 1,
+                                            std::memory_order_relaxed)) {
+                slot.value.emplace(std::move(value));
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    /// Remove and return the oldest value, or nullopt if the queue is empty.
+    /** Must only be called from a single thread at a time. */
+    [[nodiscard]] auto try_pop() -> std::optional<T>
+    {
+        auto& slot = slots_[head_ & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1)
+            return std::nullopt;
+        auto result = std::optional<T>{std::move(*slot.value)};
+        slot.value.reset();
+        slot.sequence.store(head_ + Capacity, std::memory_order_release);
+        ++head_;
+        return result;
+    }
+
+    /// Return the maximum number of values the queue can hold.
+    [[nodiscard]] static constexpr auto capacity() -> std::size_t
+    {
+        return Capacity;
+    }
+
+   private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        std::optional<T> value;
+    };
+
+    static constexpr auto mask = Capacity - 1;
+
+    std::unique_ptr<Slot[]> slots_;
+
+    // Kept on separate cache lines, they are written by different threads.
+    alignas(64) std::atomic<std::size_t> tail_ = 0;
+    alignas(64) std::size_t head_              = 0;
+};
+
+}  // namespace ox
+#endif  // CATERM_COMMON_MPSC_QUEUE_HPP
@@ -0,0 +1,63 @@
+#ifndef CATERM_PAINTER_DETAIL_OCCLUSION_HPP
+#define CATERM_PAINTER_DETAIL_OCCLUSION_HPP
+#include <vector>
+
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace ox {
+class Widget;
+}  // namespace ox
+
+namespace ox::detail {
+
+/// A run of \p width cells within a single row, starting at global Point \p at.
+struct Run {
+    ox::Point at;
+    int width;
+};
+
+/// The half open range of Runs [first, last) left for a wallpaper fill.
+struct Wallpaper_runs {
+    Run const* first;
+    Run const* last;
+};
+
+/// Records which cells of the screen are covered by painted rectangles.
+/** Each row keeps sorted, disjoint spans of covered columns, so covering and
+ *  querying a rectangle costs a few span visits per row, not one per cell. */
+class Occlusion {
+   public:
+    /// Uncover every cell and size the screen to \p a.
+    /** Keeps the memory held by each row. */
+    void reset(ox::Area a);
+
+    /// Cover the rectangle at global Point \p p with size \p a.
+    /** Cells outside of the screen are ignored. */
+    void cover(ox::Point p, ox::Area a);
+
+    /// Append the uncovered Runs of the rectangle at \p p with size \p a.
+    /** Runs are appended in row order to \p runs_out, an out parameter to
+     *  reduce allocations. Cells outside of the screen are never visible. */
+    void uncovered(ox::Point p, ox::Area a, std::vector<Run>& runs_out) const;
+
+   private:
+    /// Half open range of columns [begin, end).
+    struct Span {
+        int begin;
+        int end;
+    };
+
+    std::vector<std::vector<Span>> rows_;
+    int width_ = 0;
+};
+
+/// Return true if painting \p w covers every cell of its area.
+/** Every painted Widget is first filled with its wallpaper, which covers the
+ *  cells underneath unless the wallpaper Glyph is null. A Widget with event
+ *  filters installed is never opaque, a filter may handle its Paint_event and
+ *  paint nothing. */
+[[nodiscard]] auto is_opaque(Widget const& w) -> bool;
+
+}  // namespace ox::detail
+#endif  // CATERM_PAINTER_DETAIL_OCCLUSION_HPP
@@ -0,0 +1,79 @@
+#ifndef CATERM_PAINTER_DETAIL_PAINT_CACHE_HPP
+#define CATERM_PAINTER_DETAIL_PAINT_CACHE_HPP
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include <caterm/painter/glyph.hpp>
+#include <caterm/painter/paint_cache_stats.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace ox::detail {
+
+/// The Glyphs a Widget last painted, to be put back without painting again.
+/** Holds one Glyph per cell of the Widget, a null Glyph is a cell that the
+ *  Widget left untouched. Cells outside of the Canvas are not cached. */
+class Paint_cache {
+   public:
+    /// Columns [left, right) and rows [top, bottom) of a clipped rectangle.
+    struct Bounds {
+        int left;
+        int right;
+        int top;
+        int bottom;
+    };
+
+   public:
+    /// Mark the cached Glyphs as out of date, the next paint will render.
+    /** Safe to call from any thread, Widget::update() can be. */
+    void invalidate();
+
+    /// Write the cached Glyphs to the rectangle at \p top_left in \p canvas.
+    /** Returns false, writing nothing, if the cache is out of date, was
+     *  rendered at a size other than \p area, or the part of the rectangle on
+     *  \p canvas was not all on the Canvas when rendered. Counts a hit if
+     *  true. */
+    [[nodiscard]] auto blit(Point top_left, Area area, Canvas& canvas) -> bool;
+
+    /// Call \p paint to paint the rectangle at \p top_left, then cache it.
+    /** \p paint is expected to write into \p canvas within the rectangle.
+     *  Counts a miss and remembers how long \p paint took. */
+    template <typename Fn>
+    void render(Point top_left, Area area, Canvas& canvas, Fn&& paint)
+    {
+        this->begin_render(top_left, area, canvas);
+        auto const start = std::chrono::steady_clock::now();
+        std::forward<Fn>(paint)();
+        this->end_render(top_left, area, canvas,
+                         std::chrono::steady_clock::now() - start);
+    }
+
+    /// Return the stats summed over every Paint_cache so far.
+    [[nodiscard]] static auto total_stats() -> Paint_cache_stats;
+
+   private:
+    std::vector<Glyph> glyphs_;
+    Area area_      = {0, 0};
+    Bounds cached_  = {0, 0, 0, 0};  // Relative to top_left when rendered.
+    bool is_opaque_ = false;  // No null Glyphs, rows can be copied as is.
+    std::chrono::nanoseconds render_time_ = std::chrono::nanoseconds{0};
+
+    // Cleared by invalidate() from any thread, set before painting begins.
+    std::atomic<bool> is_valid_ = false;
+
+   private:
+    /// Save the cells underneath the rectangle, then set them to null.
+    void begin_render(Point top_left, Area area, Canvas& canvas);
+
+    /// Cache the rectangle, then put back the saved cells left untouched.
+    void end_render(Point top_left,
+                    Area area,
+                    Canvas& canvas,
+                    std::chrono::nanoseconds render_time);
+};
+
+}  // namespace ox::detail
+#endif  // CATERM_PAINTER_DETAIL_PAINT_CACHE_HPP
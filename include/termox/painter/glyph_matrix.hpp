@@ -3,22 +3,61 @@
 #include <vector>
 
 #include <caterm/painter/glyph.hpp>
+#include <caterm/painter/glyph_view.hpp>
 #include <caterm/widget/area.hpp>
 #include <caterm/widget/point.hpp>
 
 namespace ox {
 
+/// Non-owning view of a rectangle of Glyphs, rows are stride Glyphs apart.
+/** Invalidated by a resize() or the destruction of the viewed Glyph_matrix. */
+class Glyph_matrix_view {
+   public:
+    /// View \p area Glyphs from \p first, with rows \p stride Glyphs apart.
+    Glyph_matrix_view(Glyph const* first, Area area, int stride);
+
+   public:
+    /// Return the width of the view.
+    [[nodiscard]] auto width() const -> int;
+
+    /// Return the height of the view.
+    [[nodiscard]] auto height() const -> int;
+
+    /// Return the number of Glyphs from the start of one row to the next.
+    [[nodiscard]] auto stride() const -> int;
+
+    /// Glyph access operator. {0, 0} is top left of the view.
+    /** Provides no bounds checking. */
+    [[nodiscard]] auto operator()(Point p) const -> Glyph;
+
+    /// Return a view of the width() contiguous Glyphs of row \p y.
+    /** Provides no bounds checking. */
+    [[nodiscard]] auto row(int y) const -> Glyph_view;
+
+    /// Return a view of the rectangle at \p offset with size \p area.
+    /** The rectangle is clipped to this view. */
+    [[nodiscard]] auto view(Point offset, Area area) const
+        -> Glyph_matrix_view;
+
+   private:
+    Glyph const* first_;
+    Area area_;
+    int stride_;
+};
+
 /// Holds a matrix of Glyphs, provides simple access by indices.
+/** Glyphs are stored in a single row-major buffer. */
 class Glyph_matrix {
    public:
     /// Construct with a set width and height, or defaults to 0 for each.
-    /** Glyphs default constructed(space char with no colors or traits). */
+    /** Glyphs default constructed(null char with no colors or traits). */
     explicit Glyph_matrix(Area area);
 
    public:
     /// Resize the width and height of the matrix.
     /** New Glyphs will be default constructed, Glyphs no longer within the
-     *  bounds of the matrix will be destructed. */
+     *  bounds of the matrix are dropped. Rows are moved within the buffer,
+     *  which only allocates when it grows past its capacity. */
     void resize(Area area);
 
     /// Remove all Glyphs from the matrix and set width/height to 0.
@@ -46,8 +85,25 @@ class Glyph_matrix {
     /** Has bounds checking and throws std::out_of_range if not within range. */
     [[nodiscard]] auto at(Point p) const -> Glyph;
 
+    /// Return a pointer to the width() contiguous Glyphs of row \p y.
+    /** Provides no bounds checking. */
+    [[nodiscard]] auto row(int y) -> Glyph*;
+
+    /// Return a view of the width() contiguous Glyphs of row \p y.
+    /** Provides no bounds checking. */
+    [[nodiscard]] auto row(int y) const -> Glyph_view;
+
+    /// Return a view of the entire matrix.
+    [[nodiscard]] auto view() const -> Glyph_matrix_view;
+
+    /// Return a view of the rectangle at \p offset with size \p area.
+    /** The rectangle is clipped to the matrix. */
+    [[nodiscard]] auto view(Point offset, Area area) const
+        -> Glyph_matrix_view;
+
    private:
-    std::vector<std::vector<Glyph>> matrix_;
+    std::vector<Glyph> glyphs_;
+    Area area_;
 };
 
 }  // namespace ox
@@ -8,6 +8,7 @@
 #include <caterm/painter/brush.hpp>
 #include <caterm/painter/color.hpp>
 #include <caterm/painter/glyph.hpp>
+#include <caterm/painter/glyph_view.hpp>
 #include <caterm/painter/trait.hpp>
 
 namespace ox {
@@ -73,6 +74,9 @@ class Glyph_string : private std::vector<Glyph> {
         : vector<Glyph>::vector(first, last)
     {}
 
+    /// Construct with a copy of each Glyph in \p glyphs.
+    explicit Glyph_string(Glyph_view glyphs);
+
    public:
     /// Append a single Glyph to the end of *this.
     auto append(Glyph g) -> Glyph_string&;
@@ -89,6 +93,14 @@ class Glyph_string : private std::vector<Glyph> {
     /** Same as length() member function. */
     [[nodiscard]] auto size() const -> int;
 
+    /// Return a view of the \p count Glyphs starting at index \p pos.
+    /** Clipped to the Glyph_string, npos counts to the end. Does not copy, the
+     *  view is invalidated by any change to the size of *this. */
+    [[nodiscard]] auto view(int pos = 0, int count = npos) const -> Glyph_view;
+
+    /// View the entire Glyph_string.
+    [[nodiscard]] operator Glyph_view() const;
+
    public:
     /// Convert to a std::u32string, each Glyph being a char32_t.
     /** All Brush attributes are lost. */
@@ -0,0 +1,71 @@
+#ifndef CATERM_PAINTER_GLYPH_VIEW_HPP
+#define CATERM_PAINTER_GLYPH_VIEW_HPP
+#include <algorithm>
+
+#include <caterm/painter/glyph.hpp>
+
+namespace ox {
+
+/// Non-owning view of a contiguous run of Glyphs, like std::u32string_view.
+/** Cheap to copy, pass by value. Invalidated when the viewed Glyphs are moved
+ *  or destroyed. Glyph_string converts to a Glyph_view implicitly. */
+class Glyph_view {
+   public:
+    using value_type     = Glyph;
+    using size_type      = int;
+    using const_iterator = Glyph const*;
+    using iterator       = const_iterator;
+
+    /// Used to indicate 'Until the end of the view'.
+    static constexpr auto npos = -1;
+
+   public:
+    /// Construct an empty view.
+    constexpr Glyph_view() = default;
+
+    /// View the \p size Glyphs starting at \p first.
+    constexpr Glyph_view(Glyph const* first, int size)
+        : first_{first}, size_{size}
+    {}
+
+   public:
+    /// Return the number of Glyphs in the view.
+    [[nodiscard]] constexpr auto size() const -> int { return size_; }
+
+    /// Return true if there are no Glyphs in the view.
+    [[nodiscard]] constexpr auto empty() const -> bool { return size_ == 0; }
+
+    /// Return a pointer to the first Glyph.
+    [[nodiscard]] constexpr auto data() const -> Glyph const* { return first_; }
+
+    [[nodiscard]] constexpr auto begin() const -> iterator { return first_; }
+
+    [[nodiscard]] constexpr auto end() const -> iterator
+    {
+        return first_ + size_;
+    }
+
+    /// Glyph access operator, provides no bounds checking.
+    [[nodiscard]] constexpr auto operator[](int i) const -> Glyph const&
+    {
+        return first_[i];
+    }
+
+    /// Return a view of the \p count Glyphs starting at index \p pos.
+    /** The result is clipped to this view, npos counts to the end. */
+    [[nodiscard]] constexpr auto subview(int pos, int count = npos) const
+        -> Glyph_view
+    {
+        pos = std::clamp(pos, 0, size_);
+        count =
+            count == npos ? size_ - pos : std::clamp(count, 0, size_ - pos);
+        return {first_ + pos, count};
+    }
+
+   private:
+    Glyph const* first_ = nullptr;
+    int size_           = 0;
+};
+
+}  // namespace ox
+#endif  // CATERM_PAINTER_GLYPH_VIEW_HPP
@@ -0,0 +1,25 @@
+#ifndef CATERM_PAINTER_PAINT_CACHE_STATS_HPP
+#define CATERM_PAINTER_PAINT_CACHE_STATS_HPP
+#include <chrono>
+#include <cstddef>
+
+namespace ox {
+
+/// How often Widgets with a paint cache were put back instead of painted.
+struct Paint_cache_stats {
+    std::size_t hits   = 0;
+    std::size_t misses = 0;
+
+    /// Sum of the paint time of each hit, as measured when last painted.
+    std::chrono::nanoseconds time_saved = std::chrono::nanoseconds{0};
+
+    /// Return the fraction of paints served from the cache, zero if none.
+    [[nodiscard]] auto hit_rate() const -> double
+    {
+        auto const total = hits + misses;
+        return total == 0 ? 0. : static_cast<double>(hits) / total;
+    }
+};
+
+}  // namespace ox
+#endif  // CATERM_PAINTER_PAINT_CACHE_STATS_HPP
@@ -1,10 +1,16 @@
 #ifndef CATERM_PAINTER_PAINTER_HPP
 #define CATERM_PAINTER_PAINTER_HPP
+#include <optional>
+#include <utility>
+
 #include <caterm/painter/brush.hpp>
+#include <caterm/painter/detail/occlusion.hpp>
+#include <caterm/painter/glyph_view.hpp>
 #include <caterm/widget/area.hpp>
 #include <caterm/widget/point.hpp>
 
 namespace ox {
+class Glyph_matrix_view;
 class Glyph_string;
 struct Glyph;
 class Widget;
@@ -21,7 +27,11 @@ namespace ox {
 class Painter {
    public:
     /// Construct an object ready to paint Glyphs from \p w to \p canvas.
-    Painter(Widget& w, detail::Canvas& canvas);
+    /** Fills the \p wallpaper Runs with the wallpaper of \p w, or the entire
+     *  Widget if nullopt. */
+    Painter(Widget& w,
+            detail::Canvas& canvas,
+            std::optional<detail::Wallpaper_runs> wallpaper = std::nullopt);
 
     Painter(Painter const&) = delete;
     Painter(Painter&&)      = delete;
@@ -35,6 +45,14 @@ class Painter {
     /// Put Glyph_string to local coordinates.
     auto put(Glyph_string const& text, Point p) -> Painter&;
 
+    /// Put a row of \p glyphs to local coordinates, without copying them.
+    /** The row is clipped to the Widget once and written as a single run. */
+    auto put(Glyph_view glyphs, Point p) -> Painter&;
+
+    /// Put \p glyphs with its top left at local coordinates \p p.
+    /** Clipped to the Widget once, then each row is written as a single run. */
+    auto put(Glyph_matrix_view const& glyphs, Point p) -> Painter&;
+
     /// Return a copy of the Glyph at \p p, is U'\0' if Glyph is not set yet.
     [[nodiscard]] auto at(Point p) const -> Glyph;
 
@@ -60,8 +78,13 @@ class Painter {
      *  for modifying the canvas_ object. */
     void put_global(Glyph tile, Point p);
 
+    /// Put \p glyphs in a row, starting at \p p.
+    /** No bounds checking, \p glyphs must not be empty. */
+    void put_global(Glyph_view glyphs, Point p);
+
     /// Paint a line from \p a to \p b inclusive using global coordinates.
-    /** No bounds checking, used internally for Border object painting. */
+    /** No bounds checking, used internally for Border object painting. The
+     *  _no_brush version writes \p tile as is, as one run of Glyphs. */
     void hline_global(Glyph tile, Point a, Point b);
     void hline_global_no_brush(Glyph tile, Point a, Point b);
 
@@ -74,6 +97,13 @@ class Painter {
     void fill_global(Glyph tile, Point point, Area area);
     void fill_global_no_brush(Glyph tile, Point point, Area area);
 
+    /// Clip the rectangle at local \p point with size \p area to the Widget.
+    /** Also clipped to the Canvas, which the Widget can extend past. Returns
+     *  the clipped rectangle in global coordinates, its area is empty if
+     *  nothing of it is within both. */
+    [[nodiscard]] auto clip(Point point, Area area) const
+        -> std::pair<Point, Area>;
+
    private:
     Widget const& widget_;
     detail::Canvas& canvas_;
@@ -1,8 +1,13 @@
 #ifndef CATERM_SYSTEM_ANIMATION_ENGINE_HPP
 #define CATERM_SYSTEM_ANIMATION_ENGINE_HPP
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
+#include <caterm/common/deadline_queue.hpp>
 #include <caterm/common/lockable.hpp>
 #include <caterm/common/timer.hpp>
 #include <caterm/system/event_loop.hpp>
@@ -12,6 +17,9 @@ namespace ox {
 class Widget;
 
 /// Registers Widgets with intervals to send timer events.
+/** Each Widget's next deadline is kept in a Deadline_queue, a tick only visits
+ *  the Widgets that are due. Registering and unregistering is O(log n), and
+ *  amortized O(1) for dropping the deadlines left stale by unregistering. */
 class Animation_engine : private Lockable<std::recursive_mutex> {
    public:
     using Clock_t    = Timer::Clock_t;
@@ -20,7 +28,7 @@ class Animation_engine : private Lockable<std::recursive_mutex> {
 
     struct Registered_data {
         Interval_t interval;
-        Time_point last_event_time;
+        std::uint64_t id;  // Of the registration, to match its deadline.
     };
 
     static auto constexpr default_interval = Interval_t{100};
@@ -38,6 +46,12 @@ class Animation_engine : private Lockable<std::recursive_mutex> {
     /// Return true if there are no registered widgets
     [[nodiscard]] auto is_empty() const -> bool;
 
+    /// Return the number of deadlines queued, including stale ones.
+    [[nodiscard]] auto deadline_count() const -> std::size_t;
+
+    /// Return the earliest deadline queued, or nullopt if there are none.
+    [[nodiscard]] auto earliest_deadline() const -> std::optional<Time_point>;
+
     /// Start another thread that waits on intervals and sents timer events.
     void start();
 
@@ -48,11 +62,24 @@ class Animation_engine : private Lockable<std::recursive_mutex> {
     [[nodiscard]] auto is_running() const -> bool;
 
    private:
-    std::map<Widget*, Registered_data> subjects_;
+    struct Deadline {
+        Widget* widget;
+        std::uint64_t id;
+    };
+
+    std::unordered_map<Widget*, Registered_data> subjects_;
+    Deadline_queue<Deadline> deadlines_;  // Stale if id has been unregistered.
+    std::uint64_t next_id_ = 0;
     Event_loop loop_;
     Timer timer_ = Timer{default_interval};
 
    private:
+    /// Return true if \p d is from a registration that has since ended.
+    [[nodiscard]] auto is_stale(Deadline const& d) const -> bool;
+
+    /// Remove the stale deadlines once they outnumber the registered Widgets.
+    void drop_stale_deadlines();
+
     /// Post any Timer_events that are ready to be posted.
     auto get_timer_events() -> std::vector<Timer_event>&;
 
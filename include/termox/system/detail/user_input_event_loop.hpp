@@ -9,6 +9,8 @@ namespace ox::detail {
 class User_input_event_loop {
    public:
     /// Starts listening for user input events in the thread called from.
+    /** Returns after exit() is called, or with zero once the Terminal's
+     *  backend has no more input. */
     auto run() -> int;
 
     /// Sets exit flag.
@@ -0,0 +1,51 @@
+#ifndef CATERM_SYSTEM_DETAIL_WIDGET_INDEX_HPP
+#define CATERM_SYSTEM_DETAIL_WIDGET_INDEX_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ox {
+class Widget;
+}  // namespace ox
+
+namespace ox::detail {
+
+/// Map from Widget address to an index, used to find an Event already queued.
+/** Open addressed with linear probing. Each slot is stamped with the
+ *  generation it was written in, so clear() is O(1) and the slots are reused
+ *  from frame to frame without being visited. */
+class Widget_index {
+   public:
+    /// Return a pointer to the index stored for \p w, or nullptr if none.
+    [[nodiscard]] auto find(Widget const* w) -> std::uint32_t*;
+
+    /// Store \p index for \p w, return true if \p w was not already stored.
+    auto insert_or_assign(Widget const* w, std::uint32_t index) -> bool;
+
+    /// Return the number of Widgets stored.
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    /// Remove every Widget.
+    void clear();
+
+   private:
+    struct Slot {
+        Widget const* widget     = nullptr;
+        std::uint32_t generation = 0;  // Empty unless it matches generation_.
+        std::uint32_t index      = 0;
+    };
+
+    std::vector<Slot> slots_;  // Size is zero or a power of two.
+    std::uint32_t generation_ = 1;
+    std::size_t size_         = 0;
+
+   private:
+    /// Return the slot holding \p w, or the empty slot where it would go.
+    [[nodiscard]] auto lookup(Widget const* w) -> Slot&;
+
+    /// Double the number of slots and re-insert each stored Widget.
+    void grow();
+};
+
+}  // namespace ox::detail
+#endif  // CATERM_SYSTEM_DETAIL_WIDGET_INDEX_HPP
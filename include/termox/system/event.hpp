@@ -10,6 +10,7 @@
 #include <esc/event.hpp>
 
 #include <caterm/painter/color.hpp>
+#include <caterm/painter/detail/occlusion.hpp>
 #include <caterm/system/key.hpp>
 #include <caterm/system/mouse.hpp>
 #include <caterm/widget/area.hpp>
@@ -22,6 +23,10 @@ using Widget_ref = std::reference_wrapper<Widget>;
 
 struct Paint_event {
     Widget_ref receiver;
+
+    /// Wallpaper cells to fill, every cell of the receiver if nullopt.
+    /** Set by the Paint_queue, leaves out cells painted over later on. */
+    std::optional<detail::Wallpaper_runs> wallpaper = std::nullopt;
 };
 
 struct Key_press_event {
@@ -1,13 +1,19 @@
 #ifndef CATERM_SYSTEM_EVENT_QUEUE_HPP
 #define CATERM_SYSTEM_EVENT_QUEUE_HPP
+#include <atomic>
 #include <cstddef>
+#include <mutex>
 #include <utility>
 #include <vector>
 
-#include <caterm/common/unique_queue.hpp>
+#include <caterm/common/mpsc_queue.hpp>
+#include <caterm/painter/detail/occlusion.hpp>
+#include <caterm/system/detail/widget_index.hpp>
 #include <caterm/system/event_fwd.hpp>
+#include <caterm/system/geometry_stats.hpp>
 
 namespace ox {
+class Widget;
 
 [[nodiscard]] auto operator<(Paint_event const& x, Paint_event const& y)
     -> bool;
@@ -19,17 +25,41 @@ namespace ox {
 
 namespace ox::detail {
 
+/// Holds one Paint_event per Widget, in the order of each Widget's last paint.
+/** Duplicates are found through a Widget_index to each Widget's latest
+ *  Paint_event, so a frame of n requests is deduplicated in O(n). */
 class Paint_queue {
    public:
     void append(Paint_event e);
 
+    /// Remove all but the last Paint_event to each Widget, keeping their order.
+    /** Called by send_all(). */
+    void compress();
+
     /// Return true if any events are actually sent.
+    /** Wallpaper cells that a later opaque Widget paints over are not filled,
+     *  and a Widget with none of its cells left to be seen is not sent. */
     auto send_all() -> bool;
 
+    /// Remove every Paint_event without sending it.
+    void clear();
+
+    /// Return the number of Paint_events, including duplicates if any.
     [[nodiscard]] auto size() const -> std::size_t;
 
    private:
-    Unique_queue<Paint_event> events_;
+    std::vector<Paint_event> events_;
+    Widget_index latest_;  // Index into events_ of each Widget's last event.
+
+    Occlusion occlusion_;
+    std::vector<Run> runs_;
+
+    /// Range of runs_ left visible for each event, in the order of events_.
+    std::vector<std::pair<std::size_t, std::size_t>> wallpapers_;
+
+   private:
+    /// Fill wallpapers_ by visiting events_ from the last painted to first.
+    void find_visible_wallpaper();
 };
 
 class Delete_queue {
@@ -46,14 +76,110 @@ class Delete_queue {
 
 class Basic_queue {
    public:
+    /// Append \p e, or fold it into an Event that is still waiting to be sent.
+    /** A Window_resize directly after a pending Window_resize replaces it, as
+     *  does a Mouse_move_event directly after one to the same Widget. A
+     *  Move_event or Resize_event to a Widget that already has one pending
+     *  updates the pending one, so each Widget is moved and resized at most
+     *  once per send_all(), to its final geometry, in the order its parents
+     *  laid it out. */
     void append(Event e);
 
     auto send_all() -> bool;
 
     [[nodiscard]] auto size() const -> std::size_t;
 
+    /// Return the Move_events and Resize_events sent by every Basic_queue.
+    [[nodiscard]] static auto total_geometry_stats() -> Geometry_stats;
+
    private:
     std::vector<Event> basics_;
+    std::size_t next_ = 0;  // Index of the next Event to be sent.
+
+    // Index into basics_ of the last Move_event and Resize_event to a Widget.
+    Widget_index moves_;
+    Widget_index resizes_;
+
+    Geometry_stats stats_;  // Since the last send_all().
+
+    /// Heights of the Window_resizes folded into the one at basics_[index].
+    struct Folded_resize {
+        std::size_t index;
+        int first_height;  // Of the first, which was replaced.
+        bool shrank;       // If one was shorter than the one before it.
+    };
+    std::vector<Folded_resize> folded_resizes_;
+
+   private:
+    /// Fold \p e into the last pending Event, return false if it can't be.
+    /** Only touches this queue, it is called from append(), without holding
+     *  Event_queue::send_mutex(). */
+    [[nodiscard]] auto collapse(::esc::Window_resize const& e) -> bool;
+
+    /// Flag a full repaint if a Window_resize folded into basics_[index] had
+    /// made the terminal shorter. Called from send_all(), under the lock.
+    void repaint_if_shrunk(std::size_t index) const;
+
+    /// Fold \p e into the last pending Event, if it moves the same Widget.
+    [[nodiscard]] auto collapse(Mouse_move_event const& e) -> bool;
+
+    /// Fold \p e into a pending Move_event to the same Widget, if any.
+    [[nodiscard]] auto collapse(Move_event const& e) -> bool;
+
+    /// Fold \p e into a pending Resize_event to the same Widget, if any.
+    [[nodiscard]] auto collapse(Resize_event const& e) -> bool;
+};
+
+/// Events posted to an Event_queue from threads other than the one sending it.
+/** Backed by a lock free Mpsc_queue. If that fills up, Events spill over into
+ *  a mutex guarded vector until the consumer catches up. Events posted from
+ *  one thread are taken out in the order they were posted. */
+class Inbox {
+   public:
+    Inbox();
+    ~Inbox();
+
+   public:
+    /// Append \p e, safe to call from any thread.
+    /** Return true if this is the first Event since the last take_all(), the
+     *  consumer might be waiting and should be woken. */
+    auto append(Event e) -> bool;
+
+    /// Call \p f with each Event appended so far, oldest first.
+    /** Must only be called from the thread that sends the owning queue. */
+    template <typename F>
+    void take_all(F&& f)
+    {
+        // An exchange, so a post() that saw woken_ still set is taken below.
+        woken_.exchange(false, std::memory_order_acq_rel);
+        while (auto e = ring_.try_pop())
+            f(std::move(*e));
+        if (!spilled_.load(std::memory_order_acquire))
+            return;
+        {
+            // Posts that raced with the flag being set are older than any
+            // spilled Event from the same thread, they are taken first.
+            auto const lock = std::lock_guard{spill_mtx_};
+            while (auto e = ring_.try_pop())
+                f(std::move(*e));
+            spill_.swap(taken_);
+            spilled_.store(false, std::memory_order_release);
+        }
+        for (auto& e : taken_)
+            f(std::move(e));
+        taken_.clear();
+    }
+
+   private:
+    static constexpr auto capacity = std::size_t{1'024};
+
+    Mpsc_queue<Event, capacity> ring_;
+    std::atomic<bool> woken_ = false;
+
+    std::mutex spill_mtx_;
+    std::vector<Event> spill_;  // Guarded by spill_mtx_.
+    std::atomic<bool> spilled_ = false;
+    std::vector<Event> taken_;  // Only touched by the consumer.
 };
 
 }  // namespace ox::detail
@@ -63,12 +189,33 @@ namespace ox {
 class Event_queue {
    public:
     /// Adds the given event with priority for the underlying event type.
+    /** Only valid from the thread running this queue's Event_loop, or from
+     *  within a send_all() call, see post(). */
     void append(Event e);
 
-    /// Send all events, then flush the screen if any events were actually sent.
+    /// Add \p e from any thread, it is appended at the next send_all().
+    /** Lock free while fewer than a thousand Events are waiting. Returns true
+     *  if the thread sending this queue should be woken to see \p e. */
+    auto post(Event e) -> bool;
+
+    /// Send all events, then request a frame if any events were actually sent.
+    /** The frame is flushed to the screen by Terminal::frame_scheduler. */
     void send_all();
 
+    /// Return the mutex that is held while any Event_queue is sending Events.
+    /** Anything that touches the Widget tree or the screen buffers from outside
+     *  of send_all() must hold this. */
+    [[nodiscard]] static auto send_mutex() -> std::mutex&;
+
+    /// Return true if the calling thread is inside of an Event_queue::send_all.
+    [[nodiscard]] static auto is_sending() -> bool;
+
    private:
+    inline static std::mutex send_mutex_;
+    inline static thread_local bool is_sending_ = false;
+
+    detail::Inbox inbox_;
+
     detail::Basic_queue basics_;
     detail::Paint_queue paints_;
     detail::Delete_queue deletes_;
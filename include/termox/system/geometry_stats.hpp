@@ -0,0 +1,22 @@
+#ifndef CATERM_SYSTEM_GEOMETRY_STATS_HPP
+#define CATERM_SYSTEM_GEOMETRY_STATS_HPP
+#include <cstddef>
+
+namespace ox {
+
+/// Move_events and Resize_events posted, and how many were left to be sent.
+/** Events posted to a Widget that already has one of the same kind waiting are
+ *  folded into the waiting one, see System::geometry_stats(). */
+struct Geometry_stats {
+    std::size_t posted = 0;
+    std::size_t sent   = 0;
+
+    /// Return the number of events folded into another before being sent.
+    [[nodiscard]] auto coalesced() const -> std::size_t
+    {
+        return posted - sent;
+    }
+};
+
+}  // namespace ox
+#endif  // CATERM_SYSTEM_GEOMETRY_STATS_HPP
@@ -6,6 +6,8 @@
 
 #include <signals_light/signal.hpp>
 
+#include <caterm/painter/paint_cache_stats.hpp>
+#include <caterm/system/geometry_stats.hpp>
 #include <caterm/system/animation_engine.hpp>
 #include <caterm/system/detail/user_input_event_loop.hpp>
 #include <caterm/system/event_fwd.hpp>
@@ -129,7 +131,9 @@ class System {
     /// Append the event to the Event_queue for the thread it was called on.
     /** The Event_queue is processed once per iteration of the Event_loop. When
      *  the Event is pulled from the Event_queue, it is processed by
-     *  System::send_event() */
+     *  System::send_event(). Safe to call from any thread, outside of event
+     *  handling the Event is posted to the user input loop's queue and that
+     *  loop is woken up if it is waiting on input. */
     static void post_event(Event e);
 
     /// Sets the exit flag for the user input event loop.
@@ -152,6 +156,14 @@ class System {
     /** Does not stop the animation_engine, even if its empty. */
     static void disable_animation(Widget& w);
 
+    /// Return the hits and misses of every Widget paint cache so far.
+    /** See Widget::enable_paint_cache(). */
+    [[nodiscard]] static auto paint_cache_stats() -> Paint_cache_stats;
+
+    /// Return the Move_events and Resize_events posted and sent so far.
+    /** Shows how many were coalesced, see Geometry_stats. */
+    [[nodiscard]] static auto geometry_stats() -> Geometry_stats;
+
     /// Set the terminal cursor via \p cursor parameters and \p offset applied.
     static void set_cursor(Cursor cursor, Point offset);
 
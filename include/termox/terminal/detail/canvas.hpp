@@ -1,20 +1,30 @@
 #ifndef CATERM_TERMINAL_DETAIL_CANVAS_HPP
 #define CATERM_TERMINAL_DETAIL_CANVAS_HPP
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include <caterm/painter/color.hpp>
 #include <caterm/painter/glyph.hpp>
+#include <caterm/terminal/detail/color_rows.hpp>
 #include <caterm/widget/area.hpp>
 #include <caterm/widget/point.hpp>
 
 namespace ox::detail {
 
+struct Scroll;
+
 /// A 2D field of Glyphs, useful as a screen buffer.
 /** Used by Painter to write output to, which is eventually written to the
- *  actual terminal screen. */
+ *  actual terminal screen. Each row records the span of columns written to
+ *  through at() since the last reset(), so merge(), merge_and_diff() and
+ *  reset() only have to visit those cells. Every write goes through at(), there
+ *  are no mutable iterators that could bypass the dirty spans. The Colors used
+ *  by each row are kept in a Color_rows index, so generate_color_diff() only
+ *  has to visit the rows that use a Color. */
 class Canvas {
    private:
     using Buffer_t = std::vector<Glyph>;
@@ -23,6 +33,13 @@ class Canvas {
     /// Type used to model differences between two Canvas objects.
     using Diff = std::vector<std::pair<ox::Point, ox::Glyph>>;
 
+    /// Half open range of columns [begin, end) within a single row.
+    /** Empty if begin >= end. */
+    struct Dirty_span {
+        int begin = 0;
+        int end   = 0;
+    };
+
    public:
     /// Construct a new Canvas with Area of \p a.
     Canvas(ox::Area a);
@@ -34,57 +51,134 @@ class Canvas {
     /// Return the Glyph at Point \p p.
     [[nodiscard]] auto at(ox::Point p) const -> ox::Glyph;
 
-    /// Return the Glyph at Point \p p.
+    /// Return the Glyph at Point \p p, marks the cell as written to.
     [[nodiscard]] auto at(ox::Point p) -> ox::Glyph&;
 
+    /// Return the \p width Glyphs of row p.y from column p.x on, marks them.
+    /** Same as calling at() for each cell, for writing whole runs at once.
+     *  \p width must be at least one and the run must fit within the row. */
+    [[nodiscard]] auto at(ox::Point p, int width) -> ox::Glyph*;
+
+    /// Return the columns of row \p y written to through at() since reset().
+    [[nodiscard]] auto dirty_span(int y) const -> Dirty_span;
+
+    /// Return the number of rows with a non-empty dirty_span().
+    [[nodiscard]] auto dirty_row_count() const -> int;
+
+    /// Return the Colors used by each row.
+    /** Rows written to through at() since reset() are not indexed, see
+     *  dirty_span(). */
+    [[nodiscard]] auto color_rows() const -> Color_rows const&;
+
    public:
     /// Resize the Canvas to the given Area \p a.
-    /** Will throw out any Glyphs from the current Canvas that no longer fit. */
+    /** Will throw out any Glyphs from the current Canvas that no longer fit.
+     *  Rows are copied into a second buffer that is kept between calls, once
+     *  both buffers are large enough a resize does not allocate. */
     void resize(ox::Area a);
 
    public:
-    /// Return begin iterator to internal buffer.
-    [[nodiscard]] auto begin() -> Buffer_t::iterator;
-
     /// Return begin iterator to internal buffer.
     [[nodiscard]] auto begin() const -> Buffer_t::const_iterator;
 
-    /// Return end iterator to internal buffer.
-    [[nodiscard]] auto end() -> Buffer_t::iterator;
-
     /// Return end iterator to internal buffer.
     [[nodiscard]] auto end() const -> Buffer_t::const_iterator;
 
-    /// Sets all Glyphs to default construction.
+    // Writes through iterators would not be recorded, use at() instead.
+    auto begin() -> Buffer_t::iterator = delete;
+    auto end() -> Buffer_t::iterator   = delete;
+
+    /// Sets the Glyphs in the dirty spans to default construction, clears spans.
+    /** Cells outside of the dirty spans are not visited, so resetting an idle
+     *  Canvas costs one check per row. color_rows() is left as is, it is only
+     *  read from the Canvas merged into, which is never reset. */
     void reset();
 
    private:
     Buffer_t buffer_;
     ox::Area area_;
+    std::vector<Dirty_span> dirty_;  // One per row.
+    int dirty_row_count_ = 0;
+    Color_rows colors_;
 
     std::unique_ptr<Canvas> resize_buffer_ = nullptr;
 
    private:
+    /// Grow the dirty span of row \p y to include columns [begin, end).
+    void mark_dirty(int y, int begin, int end);
+
+    /// Return the first Glyph of row \p y, writes to it are not marked dirty.
+    /** For the merge functions below, which write to the Canvas that mirrors
+     *  the terminal screen and re-index its Colors themselves. */
+    [[nodiscard]] auto row(int y) -> Glyph*;
+
+    /// Re-index all of the Colors of row \p y, for rows moved as a whole.
+    void update_color_rows(int y);
+
     // Does not swap resize_buffer_
     void swap(Canvas& x);
+
+    friend void merge(Canvas const& next, Canvas& current);
+    friend void merge_and_diff(Canvas const& next,
+                               Canvas& current,
+                               Diff& diff_out);
+    friend void apply_scroll(Scroll s, Canvas& next, Canvas& current);
+};
+
+/// A band of whole rows whose contents move vertically by some distance.
+/** Rows [top, bottom) are the scroll region. A positive distance moves the
+ *  contents up, as when lines are appended to a log, a negative distance moves
+ *  them down. The rows scrolled into view are left blank. */
+struct Scroll {
+    int top;
+    int bottom;
+    int distance;
 };
 
 /// Merge \p next into \p current.
-/** A Glyph with null(zero) symbol is considered an untouched cell. */
+/** A Glyph with null(zero) symbol is considered an untouched cell. Only the
+ *  dirty spans of \p next are visited. */
 void merge(Canvas const& next, Canvas& current);
 
 /// Merge \p next into \p current, producing a diff of the changes.
 /** The diff is stored into \p diff_out, which is cleared at the start.
  *  diff_out is an out parameter for efficiency, to reduce allocations. A
- *  Glyph with null(zero) symbol is considered an untouched cell. */
+ *  Glyph with null(zero) symbol is considered an untouched cell. Only the
+ *  dirty spans of \p next are visited. */
 void merge_and_diff(Canvas const& next,
                     Canvas& current,
                     Canvas::Diff& diff_out);
 
+/// Working buffers for find_scroll(), kept between calls so it won't allocate.
+struct Scroll_search {
+    using Row_hash = std::uint64_t;
+
+    std::vector<Row_hash> before;  // Of each row of current.
+    std::vector<Row_hash> after;   // Of each row once next is merged.
+    std::vector<std::pair<Row_hash, int>> sorted;  // before, with row index.
+    std::vector<int> distances;
+};
+
+/// Find a band of rows in \p current that \p next shows shifted vertically.
+/** Only runs of consecutive dirty rows in \p next are searched, a Widget that
+ *  scrolls repaints its whole area. Returns nullopt if scrolling would not
+ *  save at least two rows from being written out by merge_and_diff(). Once
+ *  \p search has grown to the screen height, no allocations are made. */
+[[nodiscard]] auto find_scroll(Canvas const& next,
+                               Canvas const& current,
+                               Scroll_search& search) -> std::optional<Scroll>;
+
+/// Update \p current to match a terminal screen that has done Scroll \p s.
+/** The rows scrolled into view are cleared in \p current. Their cells that are
+ *  untouched in \p next are copied there from \p current first, so the next
+ *  merge_and_diff() writes those rows out in full. */
+void apply_scroll(Scroll s, Canvas& next, Canvas& current);
+
 /// Generate a Canvas::Diff containing only the items that contain \p color.
 /** Added to the diff if \p color can be found in either the Glyph's
  *  brush.foreground or brush.background members. The diff is written to \p
- *  diff_out, to reduce allocations. */
+ *  diff_out, to reduce allocations. Only rows that use \p color, according to
+ *  canvas.color_rows(), and dirty rows are searched. */
 void generate_color_diff(Color color,
                          Canvas const& canvas,
                          Canvas::Diff& diff_out);
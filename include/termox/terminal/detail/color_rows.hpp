@@ -0,0 +1,79 @@
+#ifndef CATERM_TERMINAL_DETAIL_COLOR_ROWS_HPP
+#define CATERM_TERMINAL_DETAIL_COLOR_ROWS_HPP
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/widget/area.hpp>
+
+namespace ox::detail {
+
+/// Records which rows of a Canvas use each Color.
+/** A row uses a Color if any of its Glyphs has it as background or foreground.
+ *  Each row keeps a count of the uses of each Color, and each Color a count of
+ *  the rows using it, so a Color that is not on screen is rejected without a
+ *  scan. Counting uses lets a single changed cell be indexed on its own. */
+class Color_rows {
+   public:
+    /// Construct with Area \p a, see reset().
+    explicit Color_rows(ox::Area a);
+
+   public:
+    /// Set the size to Area \p a, each cell using the Colors of Glyph{}.
+    void reset(ox::Area a);
+
+    /// Recompute the Colors used by row \p y from its Glyphs at \p row.
+    void update(int y, Glyph const* row);
+
+    /// Index a cell of row \p y that is overwritten from \p before to \p now.
+    void replace(int y, Glyph const& before, Glyph const& now)
+    {
+        if (before.brush.background == now.brush.background &&
+            before.brush.foreground == now.brush.foreground) {
+            return;
+        }
+        this->remove(y, before.brush.background);
+        this->remove(y, before.brush.foreground);
+        this->add(y, now.brush.background);
+        this->add(y, now.brush.foreground);
+    }
+
+    /// Return the number of rows that use Color \p c.
+    [[nodiscard]] auto count(Color c) const -> int { return counts_[c.value]; }
+
+    /// Return true if row \p y uses Color \p c.
+    [[nodiscard]] auto contains(int y, Color c) const -> bool
+    {
+        return uses_[index(y, c)] != 0;
+    }
+
+   private:
+    static constexpr auto color_count = 256;
+
+    int width_ = 0;
+    std::vector<int> uses_;  // color_count per row, bg and fg each count once.
+    std::array<int, color_count> counts_ = {};
+
+   private:
+    [[nodiscard]] static auto index(int y, Color c) -> std::size_t
+    {
+        return (std::size_t)y * color_count + c.value;
+    }
+
+    void add(int y, Color c)
+    {
+        if (uses_[index(y, c)]++ == 0)
+            ++counts_[c.value];
+    }
+
+    void remove(int y, Color c)
+    {
+        if (--uses_[index(y, c)] == 0)
+            --counts_[c.value];
+    }
+};
+
+}  // namespace ox::detail
+#endif  // CATERM_TERMINAL_DETAIL_COLOR_ROWS_HPP
@@ -0,0 +1,55 @@
+#ifndef CATERM_TERMINAL_DETAIL_COLOR_SEQUENCE_TABLE_HPP
+#define CATERM_TERMINAL_DETAIL_COLOR_SEQUENCE_TABLE_HPP
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include <caterm/painter/color.hpp>
+
+namespace ox::detail {
+
+/// Maps every possible Color to a pre-encoded terminal escape sequence.
+/** Sequences are stored inline in a flat array indexed by Color::value, so a
+ *  lookup is a single index and never allocates. */
+class Color_sequence_table {
+   public:
+    /// The longest sequence that can be stored, in bytes.
+    static auto constexpr capacity = 31;
+
+   public:
+    /// Construct with every Color mapped to \p fallback.
+    /** Throws std::length_error if \p fallback is longer than capacity. */
+    explicit Color_sequence_table(std::string_view fallback);
+
+   public:
+    /// Map Color \p c to \p sequence.
+    /** Throws std::length_error if \p sequence is longer than capacity. */
+    void set(Color c, std::string_view sequence);
+
+    /// Map every Color back to the fallback sequence.
+    void reset();
+
+    /// Return the sequence for Color \p c, valid until \p c is set again.
+    [[nodiscard]] auto get(Color c) const -> std::string_view
+    {
+        auto const& s = table_[c.value];
+        return {s.bytes.data(), s.size};
+    }
+
+   private:
+    struct Sequence {
+        std::array<char, capacity> bytes;
+        std::uint8_t size = 0;
+    };
+
+    Sequence fallback_;
+    std::array<Sequence, 256> table_;
+
+   private:
+    /// Return \p sequence as a Sequence, throws if it is too long.
+    [[nodiscard]] static auto make_sequence(std::string_view sequence)
+        -> Sequence;
+};
+
+}  // namespace ox::detail
+#endif  // CATERM_TERMINAL_DETAIL_COLOR_SEQUENCE_TABLE_HPP
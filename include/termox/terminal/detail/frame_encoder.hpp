@@ -0,0 +1,89 @@
+#ifndef CATERM_TERMINAL_DETAIL_FRAME_ENCODER_HPP
+#define CATERM_TERMINAL_DETAIL_FRAME_ENCODER_HPP
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <caterm/painter/brush.hpp>
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/terminal/terminal_capabilities.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace ox::detail {
+
+/// Translates Canvas::Diff objects into terminal escape sequences.
+/** Remembers the cursor position and the active Brush on the terminal between
+ *  calls, so only the cursor movement and SGR changes that are actually needed
+ *  are emitted. Cursor movement uses implicit advancement after writing a
+ *  Glyph, or the shortest of the relative and absolute cursor sequences. Runs
+ *  of identical Glyphs within a row are written with the shortest of literal
+ *  symbols, REP, ECH or EL that the Terminal_capabilities allow. */
+class Frame_encoder {
+   public:
+    /// Function used to look up the escape sequence for a Color.
+    /** The returned view must stay valid until encode() returns. */
+    using Color_sequence_fn = std::string_view (*)(Color);
+
+   public:
+    /// Construct with functions that return the fg and bg Color sequences.
+    Frame_encoder(Color_sequence_fn foreground, Color_sequence_fn background);
+
+   public:
+    /// Append the escape sequence that will write \p diff to \p out.
+    /** Does not allocate beyond growing \p out. \p screen is the size of the
+     *  terminal, used to determine where the cursor can no longer be advanced
+     *  implicitly. A change in \p screen from the previous call invalidates
+     *  the cursor position. */
+    void encode(Canvas::Diff const& diff, Area screen, std::string& out);
+
+    /// Tell the encoder that the cursor was moved to \p p by someone else.
+    void set_cursor(Point p);
+
+    /// Forget the cursor position, the next Glyph will be positioned fully.
+    void invalidate_cursor();
+
+    /// Forget the active Brush, the next Glyph will set every SGR attribute.
+    /** Must be called when a Color's definition changes, the terminal holds
+     *  the old definition for the Color that is being tracked. */
+    void invalidate_brush();
+
+    /// Forget both the cursor position and the active Brush.
+    void invalidate();
+
+    /// Only use the optional sequences that are enabled in \p c.
+    /** None are used by default. */
+    void set_capabilities(Terminal_capabilities c);
+
+    /// Append the shortest sequence that moves the cursor to \p p.
+    void move_cursor(Point p, std::string& out);
+
+    /// Append the sequences that scroll the rows of \p s on the terminal.
+    /** Sets a scroll region (DECSTBM), then indexes (IND) or reverse indexes
+     *  (RI) once per row at its bottom or top margin, and resets the region.
+     *  The rows scrolled into view are blanked with the default Brush. */
+    void scroll(Scroll s, std::string& out);
+
+   private:
+    Color_sequence_fn foreground_sequence_;
+    Color_sequence_fn background_sequence_;
+    Terminal_capabilities capabilities_;
+    Area screen_ = Area{0, 0};
+    std::optional<Point> cursor_;
+    std::optional<Color> foreground_;
+    std::optional<Color> background_;
+
+   private:
+    /// Append the SGR sequences needed to change the active Brush to \p b.
+    void set_brush(Brush b, std::string& out);
+
+    /// Append the cheapest sequence that writes \p g to \p count cells.
+    /** The cells start at the cursor, which is at \p p, and are within a
+     *  single row. The active Brush must already be g.brush. */
+    void write_run(Point p, Glyph g, int count, std::string& out);
+};
+
+}  // namespace ox::detail
+#endif  // CATERM_TERMINAL_DETAIL_FRAME_ENCODER_HPP
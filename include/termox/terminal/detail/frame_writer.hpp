@@ -0,0 +1,79 @@
+#ifndef CATERM_TERMINAL_DETAIL_FRAME_WRITER_HPP
+#define CATERM_TERMINAL_DETAIL_FRAME_WRITER_HPP
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <caterm/terminal/frame_stats.hpp>
+#include <caterm/terminal/terminal_backend.hpp>
+
+namespace ox::detail {
+
+/// Writes frames to a Terminal_backend from a dedicated thread.
+/** Frames are handed over through three buffers that are swapped, never
+ *  copied: the caller's, one pending and one being written. A frame can be
+ *  submitted while another is written, if one is already pending the caller
+ *  is expected to drop its frame, see is_full(). */
+class Frame_writer {
+   public:
+    Frame_writer() = default;
+
+    Frame_writer(Frame_writer const&) = delete;
+    Frame_writer(Frame_writer&&)      = delete;
+    auto operator=(Frame_writer const&) -> Frame_writer& = delete;
+    auto operator=(Frame_writer&&) -> Frame_writer& = delete;
+
+    ~Frame_writer();
+
+   public:
+    /// Start the writer thread, writing to \p backend.
+    /** \p backend must outlive the thread, no-op if already started. */
+    void start(Terminal_backend& backend);
+
+    /// Write anything still pending and stop the writer thread.
+    /** No-op if not started. */
+    void stop();
+
+    /// Return true if a frame is pending behind the one being written.
+    /** Submitting now would not block, but the terminal is falling behind. */
+    [[nodiscard]] auto is_full() const -> bool;
+
+    /// Hand \p bytes over to be written, \p bytes is left empty.
+    /** Appended to the pending frame if is_full(). Written from the calling
+     *  thread if the writer thread is not running. Never waits on a write. */
+    void submit(std::string& bytes);
+
+    /// Block until is_full() is false.
+    void wait_until_ready() const;
+
+    /// Record that a frame was dropped because is_full() was true.
+    void record_dropped();
+
+    /// Return the stats of the most recently written frame.
+    [[nodiscard]] auto last_stats() const -> Frame_stats;
+
+    /// Return the stats summed over every frame written or dropped so far.
+    [[nodiscard]] auto total_stats() const -> Frame_stats;
+
+   private:
+    Terminal_backend* backend_ = nullptr;
+    std::string pending_;
+    std::string writing_;
+    bool exit_ = false;
+    Frame_stats last_;
+    Frame_stats total_;
+    mutable std::mutex mtx_;
+    mutable std::condition_variable changed_;
+    std::thread thread_;
+
+   private:
+    /// Write \p bytes and record its Frame_stats, mtx_ must not be held.
+    void write(Terminal_backend& backend, std::string const& bytes);
+
+    /// Writes pending frames until stop() is called.
+    void loop();
+};
+
+}  // namespace ox::detail
+#endif  // CATERM_TERMINAL_DETAIL_FRAME_WRITER_HPP
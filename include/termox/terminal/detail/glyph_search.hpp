@@ -0,0 +1,35 @@
+#ifndef CATERM_TERMINAL_DETAIL_GLYPH_SEARCH_HPP
+#define CATERM_TERMINAL_DETAIL_GLYPH_SEARCH_HPP
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+
+namespace ox::detail {
+
+/// Instruction sets the Glyph search kernels can be implemented with.
+enum class Glyph_search_isa { Scalar, SSE2, AVX2 };
+
+/// Return the index of the first Glyph in \p next that should be merged.
+/** A Glyph should be merged if its symbol is not null and it differs from the
+ *  Glyph at the same index in \p current. Returns \p count if none are found.
+ *  Compares Glyphs bitwise, several at a time if the CPU supports it. */
+[[nodiscard]] auto find_changed(Glyph const* next,
+                                Glyph const* current,
+                                int count) -> int;
+
+/// Return the index of the first Glyph in \p glyphs that uses Color \p c.
+/** Either as foreground or background. Returns \p count if none are found. */
+[[nodiscard]] auto find_color(Glyph const* glyphs, int count, Color c) -> int;
+
+/// Return the instruction set currently used by the search kernels.
+/** Defaults to the widest supported by the CPU at runtime. */
+[[nodiscard]] auto glyph_search_isa() -> Glyph_search_isa;
+
+/// Return true if the CPU this is running on supports \p isa.
+[[nodiscard]] auto is_supported(Glyph_search_isa isa) -> bool;
+
+/// Use \p isa for the search kernels, for testing and benchmarking.
+/** Does nothing and returns false if \p isa is not supported. */
+auto set_glyph_search_isa(Glyph_search_isa isa) -> bool;
+
+}  // namespace ox::detail
+#endif  // CATERM_TERMINAL_DETAIL_GLYPH_SEARCH_HPP
@@ -1,5 +1,7 @@
 #ifndef CATERM_TERMINAL_DETAIL_SCREEN_BUFFERS_HPP
 #define CATERM_TERMINAL_DETAIL_SCREEN_BUFFERS_HPP
+#include <optional>
+
 #include <caterm/terminal/detail/canvas.hpp>
 #include <caterm/widget/area.hpp>
 
@@ -34,6 +36,13 @@ class Screen_buffers {
      *  current, and writes that change to the returned Canvas::Diff object. */
     [[nodiscard]] auto merge_and_diff() -> Canvas::Diff const&;
 
+    /// Return a Scroll of current that would bring it closer to next.
+    /** See find_scroll() in canvas.hpp. */
+    [[nodiscard]] auto find_scroll() -> std::optional<Scroll>;
+
+    /// Apply \p s to current, after the terminal has been told to scroll.
+    void apply_scroll(Scroll s);
+
     /// Generates a Canvas::Diff, with every Glyph from current that has \p c.
     /** This isn't a true difference, it is meant to be used to generate a list
      *  of Glyphs that need to be re-written to the screen. Used by
@@ -45,6 +54,7 @@ class Screen_buffers {
 
    private:
     Canvas::Diff diff_;
+    Scroll_search scroll_search_;
 };
 
 }  // namespace ox::detail
@@ -1,8 +1,12 @@
 #ifndef CATERM_TERMINAL_DYNAMIC_COLOR_ENGINE_HPP
 #define CATERM_TERMINAL_DYNAMIC_COLOR_ENGINE_HPP
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
-#include <vector>
+#include <optional>
+#include <unordered_map>
 
+#include <caterm/common/deadline_queue.hpp>
 #include <caterm/common/lockable.hpp>
 #include <caterm/common/timer.hpp>
 #include <caterm/painter/color.hpp>
@@ -12,6 +16,9 @@
 namespace ox {
 
 /// Event loop that manages posting of Dynamic_color_events.
+/** Each Color's next deadline is kept in a Deadline_queue, a tick only visits
+ *  the Colors that are due. Deadlines left stale by unregistering or replacing
+ *  a Color are dropped once they outnumber the registered Colors. */
 class Dynamic_color_engine : private Lockable<std::mutex> {
    public:
     using Clock_t    = Timer::Clock_t;
@@ -19,16 +26,15 @@ class Dynamic_color_engine : private Lockable<std::mutex> {
     using Time_point = Timer::Time_point;
 
     struct Registered_data {
-        Color color;
         Dynamic_color dynamic;
-        Time_point last_event_time;
+        std::uint64_t id;  // Of the registration, to match its deadline.
     };
 
     static auto constexpr default_interval = Interval_t{100};
 
    public:
     /// Add a dynamic color linked to \p color.
-    /** Does not check for duplicates. */
+    /** Replaces any Dynamic_color already linked to \p color. */
     void register_color(Color color, Dynamic_color const& dynamic);
 
     /// Removes the Dynamic_color linked to \p color.
@@ -41,6 +47,12 @@ class Dynamic_color_engine : private Lockable<std::mutex> {
     /// Return true if there are no registered widgets
     [[nodiscard]] auto is_empty() const -> bool;
 
+    /// Return the number of deadlines queued, including stale ones.
+    [[nodiscard]] auto deadline_count() const -> std::size_t;
+
+    /// Return the earliest deadline queued, or nullopt if there are none.
+    [[nodiscard]] auto earliest_deadline() const -> std::optional<Time_point>;
+
     /// Start another thread that waits on intervals and sents Events.
     void start();
 
@@ -48,11 +60,24 @@ class Dynamic_color_engine : private Lockable<std::mutex> {
     void stop();
 
    private:
-    std::vector<Registered_data> data_;
+    struct Deadline {
+        Color color;
+        std::uint64_t id;
+    };
+
+    std::unordered_map<Color::Value_t, Registered_data> data_;
+    Deadline_queue<Deadline> deadlines_;  // Stale if id has been unregistered.
+    std::uint64_t next_id_ = 0;
     Event_loop loop_;
     Timer timer_ = Timer{default_interval};
 
    private:
+    /// Return true if \p d is from a registration that has since ended.
+    [[nodiscard]] auto is_stale(Deadline const& d) const -> bool;
+
+    /// Remove the stale deadlines once they outnumber the registered Colors.
+    void drop_stale_deadlines();
+
     /// Post any Dynamic_color_events that are ready to be posted.
     auto get_dynamic_color_event() -> Dynamic_color_event;
 
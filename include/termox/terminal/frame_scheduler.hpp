@@ -0,0 +1,95 @@
+#ifndef CATERM_TERMINAL_FRAME_SCHEDULER_HPP
+#define CATERM_TERMINAL_FRAME_SCHEDULER_HPP
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+#include <caterm/common/fps.hpp>
+#include <caterm/system/event_queue.hpp>
+
+namespace ox {
+
+/// Coalesces frame requests from every event loop into capped-rate flushes.
+/** A frame is flushed right away if the last one is at least one period old,
+ *  so input latency stays at most one period. Otherwise the request is
+ *  deferred to a single flush once the period has passed, and any requests
+ *  made in the meantime are merged into it. A frame dropped by
+ *  Terminal::flush_screen() is deferred until the writer thread catches up. */
+class Frame_scheduler {
+   public:
+    using Clock_t    = std::chrono::steady_clock;
+    using Time_point = Clock_t::time_point;
+    using Duration_t = Clock_t::duration;
+
+    static auto constexpr default_fps = FPS{60};
+
+   public:
+    Frame_scheduler() = default;
+
+    Frame_scheduler(Frame_scheduler const&) = delete;
+    Frame_scheduler(Frame_scheduler&&)      = delete;
+    auto operator=(Frame_scheduler const&) -> Frame_scheduler& = delete;
+    auto operator=(Frame_scheduler&&) -> Frame_scheduler& = delete;
+
+    ~Frame_scheduler();
+
+   public:
+    /// Set the maximum number of frames flushed per second.
+    /** FPS{0} removes the cap, every request is flushed immediately. */
+    void set_max_fps(FPS fps);
+
+    /// Return the maximum number of frames flushed per second.
+    [[nodiscard]] auto max_fps() const -> FPS;
+
+    /// Enable or disable adaptive pacing, disabled by default.
+    /** With adaptive pacing the period is stretched to twice the average time
+     *  it takes to flush a frame, if that is longer than the max FPS period.
+     *  This keeps a slow terminal from falling behind the application. */
+    void set_adaptive_pacing(bool enable);
+
+    /// Return true if adaptive pacing is enabled.
+    [[nodiscard]] auto is_adaptive_pacing() const -> bool;
+
+    /// Mark the screen as changed, it will be flushed within one period.
+    /** Must be called with Event_queue::send_mutex() held. The deferred flush
+     *  is made from a separate thread, which also holds the mutex. */
+    void request_frame();
+
+    /// Stop the deferred flush thread, then flush any pending frame.
+    /** The last frame is flushed on the calling thread, waiting for the writer
+     *  to take it if needed. Must not be called with Event_queue::send_mutex()
+     *  held. */
+    void stop();
+
+   private:
+    std::atomic<unsigned int> max_fps_ = default_fps.value;
+    std::atomic<bool> adaptive_        = false;
+
+    // Guarded by Event_queue::send_mutex().
+    bool pending_          = false;
+    bool blocked_          = false;  // Last flush dropped by the writer.
+    bool exit_             = false;
+    Time_point last_frame_ = Time_point{};
+    Duration_t frame_cost_ = Duration_t::zero();
+    std::condition_variable deferred_;
+    std::thread thread_;
+
+   private:
+    /// Return the minimum time between the start of two frames.
+    [[nodiscard]] auto period() const -> Duration_t;
+
+    /// Flush the screen now and record when and how long it took.
+    /** Returns false if the writer dropped the frame, it is left pending for
+     *  the caller to retry, see Terminal::flush_screen(). */
+    auto flush() -> bool;
+
+    /// Make sure the deferred flush thread is running and wake it up.
+    void defer();
+
+    /// Waits for deferred requests and flushes them once their time comes.
+    void deferred_loop();
+};
+
+}  // namespace ox
+#endif  // CATERM_TERMINAL_FRAME_SCHEDULER_HPP
@@ -0,0 +1,19 @@
+#ifndef CATERM_TERMINAL_FRAME_STATS_HPP
+#define CATERM_TERMINAL_FRAME_STATS_HPP
+#include <cstddef>
+
+namespace ox {
+
+/// Bytes and write() calls used to put frames on the terminal.
+struct Frame_stats {
+    std::size_t frames   = 0;
+    std::size_t bytes    = 0;
+    std::size_t syscalls = 0;
+
+    /// Frames skipped because the terminal had not taken the previous ones.
+    /** The changes of a dropped frame are written with the next frame. */
+    std::size_t dropped = 0;
+};
+
+}  // namespace ox
+#endif  // CATERM_TERMINAL_FRAME_STATS_HPP
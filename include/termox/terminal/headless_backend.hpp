@@ -0,0 +1,156 @@
+#ifndef CATERM_TERMINAL_HEADLESS_BACKEND_HPP
+#define CATERM_TERMINAL_HEADLESS_BACKEND_HPP
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <esc/event.hpp>
+
+#include <caterm/terminal/key_mode.hpp>
+#include <caterm/terminal/mouse_mode.hpp>
+#include <caterm/terminal/signals.hpp>
+#include <caterm/terminal/terminal_capabilities.hpp>
+#include <caterm/terminal/terminal_backend.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace ox {
+
+/// In-memory terminal with a fixed size screen and scripted input.
+/** Parses everything written to it into a virtual screen grid, so the final
+ *  screen contents and the bytes written can be checked without a tty. Input
+ *  Events are queued with push_input(), once they have all been read, read()
+ *  returns nullopt and System::run() returns. */
+class Headless_backend : public Terminal_backend {
+   public:
+    /// A color as set by an SGR sequence.
+    struct Sgr_color {
+        enum class Kind : std::uint8_t { Default, Index, RGB };
+        Kind kind           = Kind::Default;
+        std::uint32_t value = 0;  // Palette index, or 0xRRGGBB.
+    };
+
+    /// One cell of the virtual screen.
+    struct Cell {
+        /// U'\0' for the second half of a wide symbol.
+        char32_t symbol = U' ';
+        Sgr_color foreground;
+        Sgr_color background;
+
+        /// Bit n is set if SGR attribute n, from 1 to 9, is on.
+        std::uint16_t attributes = 0;
+    };
+
+   public:
+    /// Construct with a blank screen of Area \p a.
+    explicit Headless_backend(Area a = Area{80, 24});
+
+   public:
+    void initialize(Mouse_mode mouse_mode,
+                    Key_mode key_mode,
+                    Signals signals) override;
+
+    void uninitialize() override;
+
+    [[nodiscard]] auto area() const -> Area override;
+
+    /// Parse \p bytes into the virtual screen, this counts as one write call.
+    auto write(std::string_view bytes) -> std::size_t override;
+
+    /// Return the next Event given to push_input(), or nullopt if none left.
+    [[nodiscard]] auto read() -> std::optional<::esc::Event> override;
+
+    /// Same as read(), all queued input counts as available.
+    [[nodiscard]] auto read_ready() -> std::optional<::esc::Event> override;
+
+    [[nodiscard]] auto color_palette_size() const -> std::uint16_t override;
+
+    [[nodiscard]] auto has_true_color() const -> bool override;
+
+    /// Supports REP, ECH and EL, erasing to the active background Color.
+    [[nodiscard]] auto capabilities() const -> Terminal_capabilities override;
+
+   public:
+    /// Queue \p e to be returned by read().
+    void push_input(::esc::Event e);
+
+    /// Resize the screen to \p a and queue a Window_resize Event.
+    /** Content within both the old and new Area is kept. */
+    void resize(Area a);
+
+    /// Return the Cell at Point \p p on the virtual screen.
+    [[nodiscard]] auto at(Point p) const -> Cell const&;
+
+    /// Return the symbols of row \p y, wide symbols are in a single element.
+    [[nodiscard]] auto row(int y) const -> std::u32string;
+
+    /// Return the current cursor position.
+    [[nodiscard]] auto cursor() const -> Point;
+
+    /// Return true if the cursor is currently shown.
+    [[nodiscard]] auto is_cursor_visible() const -> bool;
+
+    /// Return the total number of bytes written.
+    [[nodiscard]] auto bytes_written() const -> std::size_t;
+
+    /// Return the number of calls made to write().
+    [[nodiscard]] auto write_count() const -> std::size_t;
+
+   private:
+    Area area_;
+    std::vector<Cell> screen_;
+    std::deque<::esc::Event> input_;
+
+    Point cursor_         = Point{0, 0};
+    int scroll_top_       = 0;
+    int scroll_bottom_    = area_.height;  // One past the last row.
+    bool wrap_pending_    = false;
+    bool cursor_visible_  = true;
+    Cell pen_             = Cell{};
+    char32_t last_symbol_ = U' ';  // Repeated by REP.
+    std::string unparsed_ = std::string{};
+    std::size_t bytes_    = 0;
+    std::size_t writes_   = 0;
+
+   private:
+    /// Return the Cell at \p p, for writing.
+    [[nodiscard]] auto cell(Point p) -> Cell&;
+
+    /// Parse one control sequence or symbol from the front of \p bytes.
+    /** Returns the number of bytes used, or zero if \p bytes is incomplete. */
+    [[nodiscard]] auto parse_one(std::string_view bytes) -> std::size_t;
+
+    /// Parse from after the CSI introducer to the final byte, see parse_one.
+    [[nodiscard]] auto parse_csi(std::string_view bytes) -> std::size_t;
+
+    /// Apply CSI sequence \p final, with \p private_marker and parameters.
+    void apply_csi(char final,
+                   bool private_marker,
+                   std::vector<int> const& parameters);
+
+    /// Apply an SGR sequence with \p parameters.
+    void apply_sgr(std::vector<int> const& parameters);
+
+    /// Write \p symbol at the cursor and advance it.
+    void put(char32_t symbol);
+
+    /// Move the cursor down a line, scrolling up at the bottom margin.
+    void line_feed();
+
+    /// Move the cursor up a line, scrolling down at the top margin.
+    void reverse_index();
+
+    /// Move the rows of the scroll region up by \p n, blanking the bottom.
+    /** A negative \p n moves them down and blanks the top rows. */
+    void scroll(int n);
+
+    /// Set the cells in row \p y from \p begin to \p end to blank.
+    void erase(int y, int begin, int end);
+};
+
+}  // namespace ox
+#endif  // CATERM_TERMINAL_HEADLESS_BACKEND_HPP
@@ -1,17 +1,23 @@
 #ifndef CATERM_TERMINAL_TERMINAL_HPP
 #define CATERM_TERMINAL_TERMINAL_HPP
 #include <cstdint>
+#include <optional>
+#include <string>
 
 #include <signals_light/signal.hpp>
 
 #include <caterm/painter/color.hpp>
 #include <caterm/painter/glyph.hpp>
 #include <caterm/system/event_fwd.hpp>
+#include <caterm/terminal/detail/frame_writer.hpp>
 #include <caterm/terminal/detail/screen_buffers.hpp>
 #include <caterm/terminal/dynamic_color_engine.hpp>
+#include <caterm/terminal/frame_scheduler.hpp>
+#include <caterm/terminal/frame_stats.hpp>
 #include <caterm/terminal/key_mode.hpp>
 #include <caterm/terminal/mouse_mode.hpp>
 #include <caterm/terminal/signals.hpp>
+#include <caterm/terminal/terminal_backend.hpp>
 #include <caterm/widget/area.hpp>
 
 namespace ox {
@@ -22,6 +28,9 @@ class Terminal {
 
     inline static detail::Screen_buffers screen_buffers{Area{0, 0}};
 
+    /// Decides when changes are flushed to the screen, see set_max_fps().
+    inline static Frame_scheduler frame_scheduler;
+
    public:
     /// Initializes the terminal screen into curses mode.
     /** Must be called before any input/output can occur. No-op if initialized.
@@ -60,8 +69,9 @@ class Terminal {
     [[nodiscard]] static auto area() -> Area;
 
     /// Update the screen to reflect change made by Painter since last call.
-    /** This leaves the cursor in an unknown location, the cursor must be set
-     *  separately for the currently in-focus Widget. */
+    /** Also writes anything queued by repaint_color(). This leaves the cursor
+     *  in an unknown location, the cursor must be set separately for the
+     *  currently in-focus Widget. */
     static void refresh();
 
     /// Update a Color Palette value.
@@ -69,7 +79,8 @@ class Terminal {
     static void update_color_stores(Color c, True_color tc);
 
     /// Repaints all Glyphs with \p c in their Brush to the screen.
-    /** Used by Dynamic_color_engine. */
+    /** The repaint is queued and written with the next frame. Used by
+     *  Dynamic_color_engine. */
     static void repaint_color(Color c);
 
     /// Change Color definitions.
@@ -99,15 +110,50 @@ class Terminal {
 
     /// Wait for user input, and return with a corresponding Event.
     /** Blocking call, input can be received from the keyboard, mouse, or the
-     *  terminal being resized. Will return nullopt if there is an error. */
-    [[nodiscard]] static auto read_input() -> Event;
+     *  terminal being resized. Will return nullopt if the backend has no more
+     *  input to give. */
+    [[nodiscard]] static auto read_input() -> std::optional<Event>;
+
+    /// Return the next Event if user input is already available.
+    /** Does not block, returns nullopt if no input is ready. */
+    [[nodiscard]] static auto read_ready_input() -> std::optional<Event>;
+
+    /// Block until user input is ready or wake() is called.
+    /** Returns true if input is ready to be read by read_input(), false if
+     *  woken without any. */
+    [[nodiscard]] static auto wait_for_input() -> bool;
+
+    /// Return from a wait_for_input() call, safe to call from any thread.
+    static void wake();
+
+    /// Use \p backend for all input and output from now on.
+    /** Must be called before initialize(), \p backend must outlive its use.
+     *  The default is a Tty_backend. */
+    static void set_backend(Terminal_backend& backend);
+
+    /// Return the backend currently used for input and output.
+    [[nodiscard]] static auto backend() -> Terminal_backend&;
 
     /// Sets a flag so that the next call to refresh() will repaint every cell.
     /** The repaint forces the diff to contain every cell on the terminal. */
     static void flag_full_repaint();
 
     /// Flushes all of the staged changes to the screen and sets the cursor.
-    static void flush_screen();
+    /** Cursor hide, the changes, cursor placement and cursor show are handed
+     *  to the writer thread together, and written in one write() unless the
+     *  terminal only accepts part of it. Returns false if the frame is dropped
+     *  because the writer thread has a frame pending already, the changes stay
+     *  staged for the next call then, see wait_for_output(). */
+    static auto flush_screen() -> bool;
+
+    /// Block until the writer thread can take another frame from flush_screen.
+    static void wait_for_output();
+
+    /// Return the stats of the most recently written frame.
+    [[nodiscard]] static auto last_frame_stats() -> Frame_stats;
+
+    /// Return the stats summed over every frame written or dropped so far.
+    [[nodiscard]] static auto total_frame_stats() -> Frame_stats;
 
     /// Send exit flag and wait for Dynamic_color_engine thread to shutdown.
     static void stop_dynamic_color_engine();
@@ -123,6 +169,22 @@ class Terminal {
     inline static bool is_initialized_ = false;
     inline static bool full_repaint_   = false;
     inline static bool handle_sigint_  = true;
+
+    inline static Tty_backend tty_backend_;
+    inline static Terminal_backend* backend_ = &tty_backend_;
+
+    /// Each frame is built here before being handed to frame_writer_.
+    inline static std::string frame_buffer_;
+
+    /// Writes frames from its own thread between initialize and uninitialize.
+    inline static detail::Frame_writer frame_writer_;
+
+   private:
+    /// Append the changes made by Painter since the last call to the buffer.
+    static void encode_changes();
+
+    /// Hand frame_buffer_ to the writer thread, leaves it empty.
+    static void write_frame();
 };
 
 }  // namespace ox
@@ -0,0 +1,111 @@
+#ifndef CATERM_TERMINAL_TERMINAL_BACKEND_HPP
+#define CATERM_TERMINAL_TERMINAL_BACKEND_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <esc/event.hpp>
+
+#include <caterm/terminal/key_mode.hpp>
+#include <caterm/terminal/mouse_mode.hpp>
+#include <caterm/terminal/signals.hpp>
+#include <caterm/terminal/terminal_capabilities.hpp>
+#include <caterm/widget/area.hpp>
+
+namespace ox {
+
+/// Where Terminal writes its output to and reads its input from.
+/** Terminal owns the escape sequence encoding, a backend only has to move the
+ *  bytes and Events. Set with Terminal::set_backend(). */
+class Terminal_backend {
+   public:
+    virtual ~Terminal_backend() = default;
+
+   public:
+    /// Prepare for input and output, see Terminal::initialize().
+    virtual void initialize(Mouse_mode mouse_mode,
+                            Key_mode key_mode,
+                            Signals signals) = 0;
+
+    /// Restore the state from before initialize() was called.
+    virtual void uninitialize() = 0;
+
+    /// Return the size of the screen.
+    [[nodiscard]] virtual auto area() const -> Area = 0;
+
+    /// Write all of \p bytes, return the number of write calls it took.
+    /** Called from the Frame_writer thread, while the other threads go on, so
+     *  it must not touch any state they share. */
+    virtual auto write(std::string_view bytes) -> std::size_t = 0;
+
+    /// Wait for the next input Event.
+    /** Returns nullopt if there will be no more input, this ends the user
+     *  input event loop. */
+    [[nodiscard]] virtual auto read() -> std::optional<::esc::Event> = 0;
+
+    /// Return the next input Event if one is available, without waiting.
+    /** Returns nullopt if no input is ready yet. */
+    [[nodiscard]] virtual auto read_ready() -> std::optional<::esc::Event> = 0;
+
+    /// Block until input is ready or wake() is called from another thread.
+    /** Return true if read() has input ready, false if woken without any. By
+     *  default it returns true right away, and read() does the waiting. */
+    [[nodiscard]] virtual auto wait_for_input() -> bool { return true; }
+
+    /// Make a wait_for_input() call return, safe to call from any thread.
+    /** Does nothing by default. */
+    virtual void wake() {}
+
+    /// Return the number of colors in the built in palette.
+    [[nodiscard]] virtual auto color_palette_size() const -> std::uint16_t = 0;
+
+    /// Return true if true color sequences are supported.
+    [[nodiscard]] virtual auto has_true_color() const -> bool = 0;
+
+    /// Return the optional control sequences that are supported.
+    [[nodiscard]] virtual auto capabilities() const
+        -> Terminal_capabilities = 0;
+};
+
+/// The default backend, a tty accessed through the Escape library.
+/** Output is written to stdout with POSIX write(). The Escape library buffers
+ *  its own output globally, so initialize() and uninitialize() flush it on the
+ *  calling thread and write() never touches it. Capabilities are guessed from
+ *  the TERM environment variable. wait_for_input() polls stdin along with a
+ *  pipe that wake() writes a byte to. */
+class Tty_backend : public Terminal_backend {
+   public:
+    void initialize(Mouse_mode mouse_mode,
+                    Key_mode key_mode,
+                    Signals signals) override;
+
+    void uninitialize() override;
+
+    [[nodiscard]] auto area() const -> Area override;
+
+    auto write(std::string_view bytes) -> std::size_t override;
+
+    [[nodiscard]] auto read() -> std::optional<::esc::Event> override;
+
+    [[nodiscard]] auto read_ready() -> std::optional<::esc::Event> override;
+
+    [[nodiscard]] auto wait_for_input() -> bool override;
+
+    void wake() override;
+
+    [[nodiscard]] auto color_palette_size() const -> std::uint16_t override;
+
+    [[nodiscard]] auto has_true_color() const -> bool override;
+
+    [[nodiscard]] auto capabilities() const -> Terminal_capabilities override;
+
+   private:
+    // Read and write ends of the wake() pipe, -1 while not initialized.
+    int wake_read_               = -1;
+    std::atomic<int> wake_write_ = -1;
+};
+
+}  // namespace ox
+#endif  // CATERM_TERMINAL_TERMINAL_BACKEND_HPP
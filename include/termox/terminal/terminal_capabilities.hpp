@@ -0,0 +1,18 @@
+#ifndef CATERM_TERMINAL_TERMINAL_CAPABILITIES_HPP
+#define CATERM_TERMINAL_TERMINAL_CAPABILITIES_HPP
+
+namespace ox {
+
+/// Control sequences that not every terminal supports.
+/** Terminal only uses a sequence if its flag is set, see
+ *  Terminal_backend::capabilities(). */
+struct Terminal_capabilities {
+    /// REP, repeats the preceding character.
+    bool repeat = false;
+
+    /// ECH and EL erase cells to the active background Color, terminfo's bce.
+    bool background_color_erase = false;
+};
+
+}  // namespace ox
+#endif  // CATERM_TERMINAL_TERMINAL_CAPABILITIES_HPP
@@ -16,6 +16,7 @@
 #include <caterm/common/transform_view.hpp>
 #include <caterm/painter/brush.hpp>
 #include <caterm/painter/color.hpp>
+#include <caterm/painter/detail/paint_cache.hpp>
 #include <caterm/painter/glyph.hpp>
 #include <caterm/painter/painter.hpp>
 #include <caterm/system/key.hpp>
@@ -210,6 +211,19 @@ class Widget {
     /// Return true if this Widget has animation enabled.
     [[nodiscard]] auto is_animated() const -> bool;
 
+    /// Keep the Glyphs painted by this Widget, and put them back when moved.
+    /** The Widget is only painted again after update() is called or its size
+     *  changes, any other Paint_event is served from the cache. For Widgets
+     *  with an expensive paint_event(). If \p enable is false, the cache is
+     *  dropped. */
+    void enable_paint_cache(bool enable = true);
+
+    /// Drop the paint cache, every Paint_event calls paint_event() again.
+    void disable_paint_cache();
+
+    /// Return true if this Widget has its paint cache enabled.
+    [[nodiscard]] auto has_paint_cache() const -> bool;
+
     /// Get a range containing Widget& to each child.
     [[nodiscard]] auto get_children()
     {
@@ -394,6 +408,8 @@ class Widget {
 
     std::uint16_t const unique_id_;
 
+    std::unique_ptr<detail::Paint_cache> paint_cache_ = nullptr;
+
    public:
     /// Should only be used by Move_event send() function.
     void set_top_left(Point p);
@@ -403,6 +419,10 @@ class Widget {
 
     /// Should only be used by Layout.
     void set_parent(Widget* parent);
+
+    /// Should only be used by Paint_event send() function.
+    /** Returns nullptr if the paint cache is not enabled. */
+    [[nodiscard]] auto paint_cache() -> detail::Paint_cache*;
 };
 
 /// Helper function to create a Widget instance.
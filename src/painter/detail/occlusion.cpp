@@ -0,0 +1,84 @@
+#include <caterm/painter/detail/occlusion.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <caterm/painter/detail/is_paintable.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+#include <caterm/widget/widget.hpp>
+
+namespace ox::detail {
+
+void Occlusion::reset(ox::Area a)
+{
+    rows_.resize(a.height);
+    for (auto& row : rows_)
+        row.clear();
+    width_ = a.width;
+}
+
+void Occlusion::cover(ox::Point p, ox::Area a)
+{
+    auto const left   = std::max(p.x, 0);
+    auto const right  = std::min(p.x + a.width, width_);
+    auto const top    = std::max(p.y, 0);
+    auto const bottom = std::min(p.y + a.height, (int)rows_.size());
+    if (left >= right)
+        return;
+    for (auto y = top; y < bottom; ++y) {
+        auto& row = rows_[y];
+        // Spans that overlap or touch [left, right) are merged into one.
+        auto const first = std::lower_bound(
+            std::begin(row), std::end(row), left,
+            [](Span const& s, int column) { return s.end < column; });
+        auto last = first;
+        auto span = Span{left, right};
+        for (; last != std::end(row) && last->begin <= right; ++last) {
+            span.begin = std::min(span.begin, last->begin);
+            span.end   = std::max(span.end, last->end);
+        }
+        if (first == last)
+            row.insert(first, span);
+        else {
+            *first = span;
+            row.erase(std::next(first), last);
+        }
+    }
+}
+
+void Occlusion::uncovered(ox::Point p,
+                          ox::Area a,
+                          std::vector<Run>& runs_out) const
+{
+    auto const left   = std::max(p.x, 0);
+    auto const right  = std::min(p.x + a.width, width_);
+    auto const top    = std::max(p.y, 0);
+    auto const bottom = std::min(p.y + a.height, (int)rows_.size());
+    if (left >= right)
+        return;
+    for (auto y = top; y < bottom; ++y) {
+        auto const& row = rows_[y];
+        auto x          = left;
+        auto span       = std::upper_bound(
+            std::cbegin(row), std::cend(row), left,
+            [](int column, Span const& s) { return column < s.end; });
+        for (; span != std::cend(row) && span->begin < right; ++span) {
+            if (x < span->begin)
+                runs_out.push_back({{x, y}, span->begin - x});
+            x = span->end;
+        }
+        if (x < right)
+            runs_out.push_back({{x, y}, right - x});
+    }
+}
+
+auto is_opaque(Widget const& w) -> bool
+{
+    // An event filter can swallow the Paint_event, leaving nothing painted.
+    return is_paintable(w) && w.get_event_filters().empty() &&
+           w.generate_wallpaper().symbol != U'\0';
+}
+
+}  // namespace ox::detail
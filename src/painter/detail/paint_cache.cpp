@@ -0,0 +1,148 @@
+#include <caterm/painter/detail/paint_cache.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <caterm/painter/glyph.hpp>
+#include <caterm/painter/paint_cache_stats.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace {
+
+/// Cells of the rectangle being rendered, as they were before render().
+thread_local auto underneath = std::vector<ox::Glyph>{};
+
+std::mutex stats_mtx;
+auto stats = ox::Paint_cache_stats{};
+
+/// Return the part of the rectangle at \p p with size \p a within \p c.
+/** The Bounds are empty, left >= right, if none of it is. */
+[[nodiscard]] auto clip(ox::Point p, ox::Area a, ox::detail::Canvas const& c)
+    -> ox::detail::Paint_cache::Bounds
+{
+    using Bounds = ox::detail::Paint_cache::Bounds;
+    auto const b =
+        Bounds{std::max(p.x, 0), std::min(p.x + a.width, c.area().width),
+               std::max(p.y, 0), std::min(p.y + a.height, c.area().height)};
+    return b.top < b.bottom ? b : Bounds{0, 0, 0, 0};
+}
+
+/// Return \p b with \p origin moved to {0, 0}.
+[[nodiscard]] auto relative_to(ox::detail::Paint_cache::Bounds b,
+                               ox::Point origin)
+    -> ox::detail::Paint_cache::Bounds
+{
+    return {b.left - origin.x, b.right - origin.x, b.top - origin.y,
+            b.bottom - origin.y};
+}
+
+/// Return true if \p inner is empty or lies within \p outer.
+[[nodiscard]] auto is_within(ox::detail::Paint_cache::Bounds inner,
+                             ox::detail::Paint_cache::Bounds outer) -> bool
+{
+    if (inner.left >= inner.right || inner.top >= inner.bottom)
+        return true;
+    return inner.left >= outer.left && inner.right <= outer.right &&
+           inner.top >= outer.top && inner.bottom <= outer.bottom;
+}
+
+[[nodiscard]] auto is_null(ox::Glyph const& g) -> bool
+{
+    return g.symbol == U'\0';
+}
+
+}  // namespace
+
+namespace ox::detail {
+
+void Paint_cache::invalidate()
+{
+    is_valid_.store(false, std::memory_order_release);
+}
+
+auto Paint_cache::blit(Point top_left, Area area, Canvas& canvas) -> bool
+{
+    if (!is_valid_.load(std::memory_order_acquire) || area != area_)
+        return false;
+    auto const [left, right, top, bottom] = clip(top_left, area, canvas);
+    auto const width = right - left;
+    // Cells that were off of the Canvas when rendered were never cached.
+    if (!is_within(relative_to({left, right, top, bottom}, top_left), cached_))
+        return false;
+    for (auto y = top; width > 0 && y < bottom; ++y) {
+        auto const* row = glyphs_.data() + (y - top_left.y) * area.width +
+                          (left - top_left.x);
+        if (is_opaque_) {
+            std::copy(row, row + width, canvas.at({left, y}, width));
+            continue;
+        }
+        for (auto x = 0; x < width; ++x) {
+            if (!is_null(row[x]))
+                canvas.at({left + x, y}) = row[x];
+        }
+    }
+    auto const lock = std::lock_guard{stats_mtx};
+    ++stats.hits;
+    stats.time_saved += render_time_;
+    return true;
+}
+
+auto Paint_cache::total_stats() -> Paint_cache_stats
+{
+    auto const lock = std::lock_guard{stats_mtx};
+    return stats;
+}
+
+void Paint_cache::begin_render(Point top_left, Area area, Canvas& canvas)
+{
+    // Set before painting, an invalidate() made while the Widget paints is
+    // not overwritten, and the next paint renders again. The exchange reads
+    // any earlier invalidate(), so the changes made before it are painted.
+    is_valid_.exchange(true, std::memory_order_acquire);
+    auto const [left, right, top, bottom] = clip(top_left, area, canvas);
+    auto const width = right - left;
+    underneath.clear();
+    for (auto y = top; width > 0 && y < bottom; ++y) {
+        auto* const row = canvas.at({left, y}, width);
+        underneath.insert(std::end(underneath), row, row + width);
+        std::fill(row, row + width, Glyph{});
+    }
+}
+
+void Paint_cache::end_render(Point top_left,
+                             Area area,
+                             Canvas& canvas,
+                             std::chrono::nanoseconds render_time)
+{
+    glyphs_.assign(area.width * area.height, Glyph{});
+    area_        = area;
+    render_time_ = render_time;
+
+    auto const [left, right, top, bottom] = clip(top_left, area, canvas);
+    auto const width  = right - left;
+    auto const* under = underneath.data();
+    cached_           = relative_to({left, right, top, bottom}, top_left);
+    is_opaque_        = width == area.width && bottom - top == area.height;
+    for (auto y = top; width > 0 && y < bottom; ++y, under += width) {
+        auto* const row    = canvas.at({left, y}, width);
+        auto* const cached = glyphs_.data() + (y - top_left.y) * area.width +
+                             (left - top_left.x);
+        std::copy(row, row + width, cached);
+        for (auto x = 0; x < width; ++x) {
+            if (is_null(row[x])) {
+                row[x]     = under[x];
+                is_opaque_ = false;
+            }
+        }
+    }
+
+    auto const lock = std::lock_guard{stats_mtx};
+    ++stats.misses;
+}
+
+}  // namespace ox::detail
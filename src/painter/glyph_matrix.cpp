@@ -1,48 +1,150 @@
 #include <caterm/painter/glyph_matrix.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <caterm/painter/glyph.hpp>
+#include <caterm/painter/glyph_view.hpp>
 #include <caterm/widget/area.hpp>
 #include <caterm/widget/point.hpp>
 
+namespace {
+
+/// Throw std::out_of_range if \p p is not within \p a.
+void check_bounds(ox::Point p, ox::Area a)
+{
+    if (p.x < 0 || p.y < 0 || p.x >= a.width || p.y >= a.height) {
+        throw std::out_of_range{"Glyph_matrix: Point {" + std::to_string(p.x) +
+                                ", " + std::to_string(p.y) +
+                                "} is out of range."};
+    }
+}
+
+}  // namespace
+
 namespace ox {
 
+Glyph_matrix_view::Glyph_matrix_view(Glyph const* first, Area area, int stride)
+    : first_{first}, area_{area}, stride_{stride}
+{}
+
+auto Glyph_matrix_view::width() const -> int { return area_.width; }
+
+auto Glyph_matrix_view::height() const -> int { return area_.height; }
+
+auto Glyph_matrix_view::stride() const -> int { return stride_; }
+
+auto Glyph_matrix_view::operator()(Point p) const -> Glyph
+{
+    return first_[p.y * stride_ + p.x];
+}
+
+auto Glyph_matrix_view::row(int y) const -> Glyph_view
+{
+    return {first_ + y * stride_, area_.width};
+}
+
+auto Glyph_matrix_view::view(Point offset, Area area) const
+    -> Glyph_matrix_view
+{
+    offset.x    = std::clamp(offset.x, 0, area_.width);
+    offset.y    = std::clamp(offset.y, 0, area_.height);
+    area.width  = std::clamp(area.width, 0, area_.width - offset.x);
+    area.height = std::clamp(area.height, 0, area_.height - offset.y);
+    return {first_ + offset.y * stride_ + offset.x, area, stride_};
+}
+
 Glyph_matrix::Glyph_matrix(Area area)
-    : matrix_(area.height, std::vector<Glyph>(area.width, Glyph{U'\0'}))
+    : glyphs_(area.width * area.height, Glyph{U'\0'}), area_{area}
 {}
 
 void Glyph_matrix::resize(Area area)
 {
-    matrix_.resize(area.height);
-    matrix_.shrink_to_fit();
-    for (auto& row : matrix_) {
-        row.resize(area.width, U'\0');
-        row.shrink_to_fit();
+    auto const kept_width  = std::min(area.width, area_.width);
+    auto const kept_height = std::min(area.height, area_.height);
+    auto const begin       = std::begin(glyphs_);
+    if (area.width < area_.width) {
+        // Moving toward the front, each row is read before it is written over.
+        for (auto y = 1; y < kept_height; ++y) {
+            std::copy_n(std::next(begin, y * area_.width), kept_width,
+                        std::next(begin, y * area.width));
+        }
+        glyphs_.resize(area.width * area.height);
     }
+    else if (area.width > area_.width) {
+        glyphs_.resize(area.width * area.height);
+        auto const first = std::begin(glyphs_);
+        for (auto y = kept_height - 1; y > 0; --y) {
+            auto const from = std::next(first, y * area_.width);
+            std::copy_backward(from, std::next(from, kept_width),
+                               std::next(first, y * area.width + kept_width));
+        }
+        for (auto y = 0; y < kept_height; ++y) {
+            auto const row = std::next(first, y * area.width);
+            std::fill(std::next(row, kept_width), std::next(row, area.width),
+                      Glyph{U'\0'});
+        }
+    }
+    else
+        glyphs_.resize(area.width * area.height);
+    std::fill(std::next(std::begin(glyphs_), kept_height * area.width),
+              std::end(glyphs_), Glyph{U'\0'});
+    area_ = area;
 }
 
-void Glyph_matrix::clear() { matrix_.clear(); }
-
-auto Glyph_matrix::width() const -> int
+void Glyph_matrix::clear()
 {
-    return matrix_.empty() ? 0 : matrix_.at(0).size();
+    glyphs_.clear();
+    area_ = {0, 0};
 }
 
-auto Glyph_matrix::height() const -> int { return matrix_.size(); }
+auto Glyph_matrix::width() const -> int { return area_.width; }
+
+auto Glyph_matrix::height() const -> int { return area_.height; }
 
-auto Glyph_matrix::operator()(Point p) -> Glyph& { return matrix_[p.y][p.x]; }
+auto Glyph_matrix::operator()(Point p) -> Glyph&
+{
+    return glyphs_[p.y * area_.width + p.x];
+}
 
 auto Glyph_matrix::operator()(Point p) const -> Glyph
 {
-    return matrix_[p.y][p.x];
+    return glyphs_[p.y * area_.width + p.x];
 }
 
-auto Glyph_matrix::at(Point p) -> Glyph& { return matrix_.at(p.y).at(p.x); }
+auto Glyph_matrix::at(Point p) -> Glyph&
+{
+    check_bounds(p, area_);
+    return (*this)(p);
+}
 
 auto Glyph_matrix::at(Point p) const -> Glyph
 {
-    return matrix_.at(p.y).at(p.x);
+    check_bounds(p, area_);
+    return (*this)(p);
+}
+
+auto Glyph_matrix::row(int y) -> Glyph*
+{
+    return glyphs_.data() + y * area_.width;
+}
+
+auto Glyph_matrix::row(int y) const -> Glyph_view
+{
+    return {glyphs_.data() + y * area_.width, area_.width};
+}
+
+auto Glyph_matrix::view() const -> Glyph_matrix_view
+{
+    return {glyphs_.data(), area_, area_.width};
+}
+
+auto Glyph_matrix::view(Point offset, Area area) const -> Glyph_matrix_view
+{
+    return this->view().view(offset, area);
 }
 
 }  // namespace ox
@@ -1,6 +1,7 @@
 #include <caterm/painter/glyph_string.hpp>
 
 #include <algorithm>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,7 @@
 #include <caterm/painter/brush.hpp>
 #include <caterm/painter/color.hpp>
 #include <caterm/painter/glyph.hpp>
+#include <caterm/painter/glyph_view.hpp>
 #include <caterm/painter/trait.hpp>
 
 namespace ox {
@@ -31,10 +33,21 @@ auto Glyph_string::append(Glyph_string const& gs) -> Glyph_string&
     return *this;
 }
 
+Glyph_string::Glyph_string(Glyph_view glyphs)
+    : vector<Glyph>::vector(std::begin(glyphs), std::end(glyphs))
+{}
+
 auto Glyph_string::length() const -> int { return this->size(); }
 
 auto Glyph_string::size() const -> int { return this->vector::size(); }
 
+auto Glyph_string::view(int pos, int count) const -> Glyph_view
+{
+    return Glyph_view{this->data(), this->size()}.subview(pos, count);
+}
+
+Glyph_string::operator Glyph_view() const { return this->view(); }
+
 auto Glyph_string::u32str() const -> std::u32string
 {
     auto result = std::u32string{};
@@ -1,6 +1,14 @@
 #include <caterm/painter/painter.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+#include <caterm/painter/detail/occlusion.hpp>
+#include <caterm/painter/glyph_matrix.hpp>
 #include <caterm/painter/glyph_string.hpp>
+#include <caterm/painter/glyph_view.hpp>
 #include <caterm/system/event_loop.hpp>
 #include <caterm/system/system.hpp>
 #include <caterm/terminal/detail/canvas.hpp>
@@ -9,27 +17,55 @@
 
 namespace ox {
 
-Painter::Painter(Widget& widg, detail::Canvas& canvas)
+Painter::Painter(Widget& widg,
+                 detail::Canvas& canvas,
+                 std::optional<detail::Wallpaper_runs> wallpaper)
     : widget_{widg}, canvas_{canvas}, brush_{widg.brush}
 {
-    this->wallpaper_fill();
+    if (!wallpaper.has_value()) {
+        this->wallpaper_fill();
+        return;
+    }
+    auto const tile = widget_.generate_wallpaper();
+    for (auto run = wallpaper->first; run != wallpaper->last; ++run)
+        std::fill_n(canvas_.at(run->at, run->width), run->width, tile);
 }
 
 auto Painter::put(Glyph tile, Point p) -> Painter&
 {
     // User code can contain invalid points.
-    if (p.x >= widget_.area().width || p.y >= widget_.area().height ||
-        p.x < 0 || p.y < 0) {
+    auto const [origin, area] = this->clip(p, {1, 1});
+    if (area.width == 0 || area.height == 0)
         return *this;
-    }
-    this->put_global(tile, widget_.top_left() + p);
+    this->put_global(tile, origin);
     return *this;
 }
 
 auto Painter::put(Glyph_string const& text, Point p) -> Painter&
 {
-    for (Glyph g : text)
-        this->put(g, {p.x++, p.y});
+    return this->put(text.view(), p);
+}
+
+auto Painter::put(Glyph_view glyphs, Point p) -> Painter&
+{
+    auto const row =
+        Glyph_matrix_view{glyphs.data(), {glyphs.size(), 1}, glyphs.size()};
+    return this->put(row, p);
+}
+
+auto Painter::put(Glyph_matrix_view const& glyphs, Point p) -> Painter&
+{
+    auto const [origin, area] =
+        this->clip(p, {glyphs.width(), glyphs.height()});
+    if (area.width == 0 || area.height == 0)
+        return *this;
+    // Offset of the clipped rectangle within glyphs.
+    auto const offset = Point{origin.x - (widget_.top_left().x + p.x),
+                              origin.y - (widget_.top_left().y + p.y)};
+    for (auto y = 0; y < area.height; ++y) {
+        this->put_global(glyphs.row(offset.y + y).subview(offset.x, area.width),
+                         {origin.x, origin.y + y});
+    }
     return *this;
 }
 
@@ -47,20 +83,14 @@ auto Painter::at(Point p) -> Glyph&
 
 auto Painter::fill(Glyph tile, Point point, Area area) -> Painter&
 {
-    if (area.width == 0)
-        return *this;
-    auto const y_limit = point.y + area.height;
-    auto const x_limit = point.x + area.width - 1;  // Used in inclusive context
-    for (; point.y < y_limit; ++point.y)
-        this->hline(tile, point, {x_limit, point.y});
+    auto const [origin, clipped] = this->clip(point, area);
+    this->fill_global(tile, origin, clipped);
     return *this;
 }
 
 auto Painter::hline(Glyph tile, Point a, Point b) -> Painter&
 {
-    for (; a.x <= b.x; ++a.x)
-        this->put(tile, a);
-    return *this;
+    return this->fill(tile, a, {b.x - a.x + 1, 1});
 }
 
 auto Painter::vline(Glyph tile, Point a, Point b) -> Painter&
@@ -72,8 +102,8 @@ auto Painter::vline(Glyph tile, Point a, Point b) -> Painter&
 
 auto Painter::wallpaper_fill() -> Painter&
 {
-    this->fill_global_no_brush(widget_.generate_wallpaper(), widget_.top_left(),
-                               widget_.area());
+    auto const [origin, area] = this->clip({0, 0}, widget_.area());
+    this->fill_global_no_brush(widget_.generate_wallpaper(), origin, area);
     return *this;
 }
 
@@ -85,16 +115,31 @@ void Painter::put_global(Glyph tile, Point p)
     canvas_.at(p) = tile;
 }
 
+void Painter::put_global(Glyph_view glyphs, Point p)
+{
+    auto* const row = canvas_.at(p, glyphs.size());
+    if (brush_ == Brush{}) {  // Merging with an empty Brush changes nothing.
+        std::copy(std::begin(glyphs), std::end(glyphs), row);
+        return;
+    }
+    std::transform(std::begin(glyphs), std::end(glyphs), row,
+                   [brush = brush_](Glyph g) {
+                       g.brush = merge(g.brush, brush);
+                       return g;
+                   });
+}
+
 void Painter::hline_global(Glyph tile, Point a, Point b)
 {
-    for (; a.x <= b.x; ++a.x)
-        this->put_global(tile, a);
+    tile.brush = merge(tile.brush, brush_);
+    this->hline_global_no_brush(tile, a, b);
 }
 
 void Painter::hline_global_no_brush(Glyph tile, Point a, Point b)
 {
-    for (; a.x <= b.x; ++a.x)
-        canvas_.at(a) = tile;
+    auto const width = b.x - a.x + 1;
+    if (width > 0)
+        std::fill_n(canvas_.at(a, width), width, tile);
 }
 
 void Painter::vline_global(Glyph tile, Point a, Point b)
@@ -105,12 +150,8 @@ void Painter::vline_global(Glyph tile, Point a, Point b)
 
 void Painter::fill_global(Glyph tile, Point point, Area area)
 {
-    if (area.width == 0)
-        return;
-    auto const y_limit = point.y + area.height;
-    auto const x_limit = point.x + area.width - 1;  // Used in inclusive context
-    for (; point.y < y_limit; ++point.y)
-        this->hline_global(tile, point, {x_limit, point.y});
+    tile.brush = merge(tile.brush, brush_);
+    this->fill_global_no_brush(tile, point, area);
 }
 
 void Painter::fill_global_no_brush(Glyph tile, Point point, Area area)
@@ -123,4 +164,22 @@ void Painter::fill_global_no_brush(Glyph tile, Point point, Area area)
         this->hline_global_no_brush(tile, point, {x_limit, point.y});
 }
 
+auto Painter::clip(Point point, Area area) const -> std::pair<Point, Area>
+{
+    // A Widget can extend past the edge of the screen, the Canvas ends there.
+    auto const bounds = widget_.area();
+    auto const offset = widget_.top_left();
+    auto const screen = canvas_.area();
+    auto const left   = std::max({point.x, 0, -offset.x});
+    auto const top    = std::max({point.y, 0, -offset.y});
+    auto const right  = std::min(
+        {point.x + area.width, bounds.width, screen.width - offset.x});
+    auto const bottom = std::min(
+        {point.y + area.height, bounds.height, screen.height - offset.y});
+    if (left >= right || top >= bottom)
+        return {widget_.top_left(), Area{0, 0}};
+    return {widget_.top_left() + Point{left, top},
+            Area{right - left, bottom - top}};
+}
+
 }  // namespace ox
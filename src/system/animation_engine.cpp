@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <iterator>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -24,7 +26,11 @@ namespace ox {
 void Animation_engine::register_widget(Widget& w, Interval_t interval)
 {
     auto const lock = this->Lockable::lock();
-    subjects_.insert(std::pair{&w, Registered_data{interval, Clock_t::now()}});
+    interval        = std::max(interval, Interval_t{1});
+    auto const inserted =
+        subjects_.insert({&w, Registered_data{interval, next_id_}}).second;
+    if (inserted)
+        deadlines_.push(Clock_t::now() + interval, Deadline{&w, next_id_++});
 }
 
 void Animation_engine::register_widget(Widget& w, FPS fps)
@@ -36,9 +42,28 @@ void Animation_engine::unregister_widget(Widget& w)
 {
     auto const lock = this->Lockable::lock();
     subjects_.erase(&w);
+    this->drop_stale_deadlines();
 }
 
-auto Animation_engine::is_empty() const -> bool { return subjects_.empty(); }
+auto Animation_engine::is_empty() const -> bool
+{
+    auto const lock = this->Lockable::lock();
+    return subjects_.empty();
+}
+
+auto Animation_engine::deadline_count() const -> std::size_t
+{
+    auto const lock = this->Lockable::lock();
+    return deadlines_.size();
+}
+
+auto Animation_engine::earliest_deadline() const -> std::optional<Time_point>
+{
+    auto const lock = this->Lockable::lock();
+    if (deadlines_.is_empty())
+        return std::nullopt;
+    return deadlines_.top().deadline;
+}
 
 void Animation_engine::start()
 {
@@ -62,36 +87,33 @@ void Animation_engine::loop_function(Event_queue& queue)
         queue.append(std::move(e));
 }
 
+auto Animation_engine::is_stale(Deadline const& d) const -> bool
+{
+    auto const iter = subjects_.find(d.widget);
+    return iter == std::end(subjects_) || iter->second.id != d.id;
+}
+
+void Animation_engine::drop_stale_deadlines()
+{
+    if (deadlines_.size() > 2 * subjects_.size())
+        deadlines_.erase_if([this](Deadline const& d) { return is_stale(d); });
+}
+
 auto Animation_engine::get_timer_events() -> std::vector<Timer_event>&
 {
     timer_events.clear();
-    if (subjects_.empty()) {
-        timer_.set_interval(default_interval);
-        return timer_events;
-    }
-    auto const lock    = this->Lockable::lock();
-    auto next_interval = [&, this] {
-        return std::min_element(std::cbegin(subjects_), std::cend(subjects_),
-                                [](auto const& a, auto const& b) {
-                                    return a.second.interval <
-                                           b.second.interval;
-                                })
-            ->second.interval;
-    }();
-
-    auto const now = Clock_t::now();
-    for (auto& [widget, data] : subjects_) {
-        auto const time_left = std::chrono::duration_cast<Interval_t>(
-            data.interval - (now - data.last_event_time));
-        if (time_left <= Interval_t{0}) {
-            data.last_event_time = now;
-            timer_events.push_back(Timer_event{*widget});
-        }
-        else {
-            next_interval = std::min(next_interval, time_left);
-        }
-    }
-    timer_.set_interval(next_interval);
+    auto const lock = this->Lockable::lock();
+    auto const now  = Clock_t::now();
+    auto const fire = [&](Deadline const& due) -> std::optional<Interval_t> {
+        auto const iter = subjects_.find(due.widget);
+        if (iter == std::end(subjects_) || iter->second.id != due.id)
+            return std::nullopt;  // Unregistered since it was pushed.
+        timer_events.push_back(Timer_event{*due.widget});
+        return iter->second.interval;
+    };
+    deadlines_.fire_due(now, fire);
+    // Capped, so a Widget registered in the meantime is not kept waiting.
+    timer_.set_interval(deadlines_.time_until_next(now, default_interval));
     return timer_events;
 }
 
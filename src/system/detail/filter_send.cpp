@@ -35,7 +35,8 @@ auto filter_send(ox::Paint_event const& e) -> bool
         [&e](Widget* filter) {
             if (!is_paintable(e.receiver))
                 return false;
-            auto p = Painter{e.receiver, ox::Terminal::screen_buffers.next};
+            auto p = Painter{e.receiver, ox::Terminal::screen_buffers.next,
+                             e.wallpaper};
             auto const x = filter->paint_event_filter(e.receiver, p);
             auto const y = filter->painted_filter.emit(e.receiver, p);
             return x || (y ? *y : false);
@@ -38,9 +38,23 @@ void send(ox::Paint_event e)
 {
     if (!is_paintable(e.receiver))
         return;
-    auto p = Painter{e.receiver, ox::Terminal::screen_buffers.next};
-    e.receiver.get().paint_event(p);
-    e.receiver.get().painted.emit(p);
+    auto& w      = e.receiver.get();
+    auto& canvas = ox::Terminal::screen_buffers.next;
+    auto* cache  = w.paint_cache();
+    if (cache == nullptr) {
+        auto p = Painter{w, canvas, e.wallpaper};
+        w.paint_event(p);
+        w.painted.emit(p);
+        return;
+    }
+    if (cache->blit(w.top_left(), w.area(), canvas))
+        return;
+    // Every cell is painted, cells covered now might not be on a later blit.
+    cache->render(w.top_left(), w.area(), canvas, [&] {
+        auto p = Painter{w, canvas};
+        w.paint_event(p);
+        w.painted.emit(p);
+    });
 }
 
 void send(ox::Key_press_event e)
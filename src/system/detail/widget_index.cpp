@@ -0,0 +1,70 @@
+#include <caterm/system/detail/widget_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace ox::detail {
+
+auto Widget_index::find(Widget const* w) -> std::uint32_t*
+{
+    if (size_ == 0)
+        return nullptr;
+    auto& slot = this->lookup(w);
+    return slot.generation == generation_ ? &slot.index : nullptr;
+}
+
+auto Widget_index::insert_or_assign(Widget const* w, std::uint32_t index)
+    -> bool
+{
+    if (2 * (size_ + 1) > slots_.size())
+        this->grow();
+    auto& slot = this->lookup(w);
+    if (slot.generation == generation_) {
+        slot.index = index;
+        return false;
+    }
+    slot = {w, generation_, index};
+    ++size_;
+    return true;
+}
+
+auto Widget_index::size() const -> std::size_t { return size_; }
+
+void Widget_index::clear()
+{
+    size_ = 0;
+    if (++generation_ != 0)
+        return;
+    // Stamps from the previous wrap around would look current again.
+    std::fill(std::begin(slots_), std::end(slots_), Slot{});
+    generation_ = 1;
+}
+
+auto Widget_index::lookup(Widget const* w) -> Slot&
+{
+    // Fibonacci hashing, the low bits of an address are mostly alignment.
+    auto const hash = reinterpret_cast<std::uintptr_t>(w) *
+                      std::uint64_t{0x9E3779B97F4A7C15};
+    auto const mask = slots_.size() - 1;
+    auto i          = static_cast<std::size_t>(hash >> 32) & mask;
+    while (slots_[i].generation == generation_ && slots_[i].widget != w)
+        i = (i + 1) & mask;
+    return slots_[i];
+}
+
+void Widget_index::grow()
+{
+    auto old = std::vector<Slot>(std::max(slots_.size() * 2, std::size_t{64}));
+    slots_.swap(old);
+    auto const previous = std::exchange(generation_, 1);
+    for (auto const& slot : old) {
+        if (slot.generation == previous)
+            this->lookup(slot.widget) = {slot.widget, generation_, slot.index};
+    }
+}
+
+}  // namespace ox::detail
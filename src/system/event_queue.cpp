@@ -1,12 +1,21 @@
 #include <caterm/system/event_queue.hpp>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <utility>
 #include <variant>
 
+#include <esc/event.hpp>
+
+#include <caterm/painter/detail/is_paintable.hpp>
+#include <caterm/painter/detail/occlusion.hpp>
+#include <caterm/system/detail/widget_index.hpp>
 #include <caterm/system/event.hpp>
+#include <caterm/system/geometry_stats.hpp>
 #include <caterm/system/system.hpp>
 #include <caterm/terminal/terminal.hpp>
 #include <caterm/widget/widget.hpp>
@@ -25,23 +34,83 @@ auto operator==(Paint_event const& a, Paint_event const& b) -> bool
 
 }  // namespace ox
 
+namespace {
+
+std::mutex geometry_stats_mtx;
+auto geometry_stats = ox::Geometry_stats{};
+
+}  // namespace
+
 namespace ox::detail {
 
-void Paint_queue::append(Paint_event e) { events_.append(e); }
+void Paint_queue::append(Paint_event e)
+{
+    latest_.insert_or_assign(&e.receiver.get(),
+                             static_cast<std::uint32_t>(events_.size()));
+    events_.push_back(std::move(e));
+}
+
+void Paint_queue::compress()
+{
+    if (latest_.size() == events_.size())
+        return;
+    // Keep each event that its Widget's index still points to.
+    auto kept = std::uint32_t{0};
+    for (auto i = std::uint32_t{0}; i < events_.size(); ++i) {
+        auto* const latest = latest_.find(&events_[i].receiver.get());
+        if (*latest != i)
+            continue;
+        *latest = kept;
+        if (kept != i)
+            events_[kept] = std::move(events_[i]);
+        ++kept;
+    }
+    events_.erase(std::next(std::begin(events_), kept), std::end(events_));
+}
 
 auto Paint_queue::send_all() -> bool
 {
-    events_.compress();
+    this->compress();
+    this->find_visible_wallpaper();
     /// Processing Paint_events should not post more Paint_events.
-    bool sent = false;
-    for (auto& p : events_)
-        sent = System::send_event(std::move(p)) || sent;
-    events_.clear();
+    bool sent   = false;
+    auto bounds = std::cbegin(wallpapers_);
+    for (auto& p : events_) {
+        auto const [first, last] = *bounds++;
+        if (first == last && is_paintable(p.receiver))
+            continue;  // Entirely painted over later on.
+        p.wallpaper = Wallpaper_runs{runs_.data() + first, runs_.data() + last};
+        sent        = System::send_event(std::move(p)) || sent;
+    }
+    this->clear();
     return sent;
 }
 
+void Paint_queue::clear()
+{
+    events_.clear();
+    latest_.clear();
+}
+
 auto Paint_queue::size() const -> std::size_t { return events_.size(); }
 
+void Paint_queue::find_visible_wallpaper()
+{
+    occlusion_.reset(Terminal::screen_buffers.area());
+    runs_.clear();
+    wallpapers_.resize(events_.size());
+    auto bounds = std::end(wallpapers_);
+    for (auto p = std::end(events_); p != std::begin(events_);) {
+        Widget const& w  = (*--p).receiver.get();
+        auto const first = runs_.size();
+        if (is_paintable(w))
+            occlusion_.uncovered(w.top_left(), w.area(), runs_);
+        *--bounds = {first, runs_.size()};
+        if (is_opaque(w))
+            occlusion_.cover(w.top_left(), w.area());
+    }
+}
+
 void Delete_queue::append(Delete_event e) { deletes_.push_back(std::move(e)); }
 
 void Delete_queue::send_all()
@@ -54,20 +123,150 @@ void Delete_queue::send_all()
 
 auto Delete_queue::size() const -> std::size_t { return deletes_.size(); }
 
-void Basic_queue::append(Event e) { basics_.push_back(std::move(e)); }
+void Basic_queue::append(Event e)
+{
+    if (auto const* resize = std::get_if<::esc::Window_resize>(&e);
+        resize != nullptr && this->collapse(*resize)) {
+        return;
+    }
+    if (auto const* mouse = std::get_if<Mouse_move_event>(&e);
+        mouse != nullptr && this->collapse(*mouse)) {
+        return;
+    }
+    auto const index = static_cast<std::uint32_t>(basics_.size());
+    if (auto const* move = std::get_if<Move_event>(&e); move != nullptr) {
+        ++stats_.posted;
+        if (this->collapse(*move))
+            return;
+        moves_.insert_or_assign(&move->receiver.get(), index);
+    }
+    else if (auto const* resize = std::get_if<Resize_event>(&e);
+             resize != nullptr) {
+        ++stats_.posted;
+        if (this->collapse(*resize))
+            return;
+        resizes_.insert_or_assign(&resize->receiver.get(), index);
+    }
+    basics_.push_back(std::move(e));
+}
 
 auto Basic_queue::send_all() -> bool
 {
     // Allows for send(e) appending to the queue and invalidating iterators.
     bool sent = false;
-    for (auto index = 0uL; index < basics_.size(); ++index)
-        sent = System::send_event(std::move(basics_[index])) || sent;
+    while (next_ < basics_.size()) {
+        auto const index = next_++;
+        auto& e          = basics_[index];
+        if (std::holds_alternative<Move_event>(e) ||
+            std::holds_alternative<Resize_event>(e)) {
+            ++stats_.sent;
+        }
+        else if (std::holds_alternative<::esc::Window_resize>(e))
+            this->repaint_if_shrunk(index);
+        sent = System::send_event(std::move(e)) || sent;
+    }
     basics_.clear();
+    next_ = 0;
+    moves_.clear();
+    resizes_.clear();
+    folded_resizes_.clear();
+    {
+        auto const lock = std::lock_guard{geometry_stats_mtx};
+        geometry_stats.posted += std::exchange(stats_.posted, 0);
+        geometry_stats.sent += std::exchange(stats_.sent, 0);
+    }
     return sent;
 }
 
+auto Basic_queue::total_geometry_stats() -> Geometry_stats
+{
+    auto const lock = std::lock_guard{geometry_stats_mtx};
+    return geometry_stats;
+}
+
 auto Basic_queue::size() const -> std::size_t { return basics_.size(); }
 
+auto Basic_queue::collapse(::esc::Window_resize const& e) -> bool
+{
+    if (next_ == basics_.size())
+        return false;
+    auto* const pending = std::get_if<::esc::Window_resize>(&basics_.back());
+    if (pending == nullptr)
+        return false;
+    auto const index  = basics_.size() - 1;
+    auto const height = pending->new_dimensions.height;
+    if (folded_resizes_.empty() || folded_resizes_.back().index != index)
+        folded_resizes_.push_back({index, height, false});
+    if (e.new_dimensions.height < height)
+        folded_resizes_.back().shrank = true;
+    *pending = e;
+    return true;
+}
+
+void Basic_queue::repaint_if_shrunk(std::size_t index) const
+{
+    auto const is_at = [index](Folded_resize const& f) {
+        return f.index == index;
+    };
+    auto const iter = std::find_if(std::cbegin(folded_resizes_),
+                                   std::cend(folded_resizes_), is_at);
+    if (iter == std::cend(folded_resizes_))
+        return;
+    // send(Window_resize) only sees the newest height, if the terminal was
+    // made shorter along the way it has scrolled and must be fully repainted.
+    if (iter->shrank ||
+        iter->first_height < Terminal::screen_buffers.area().height) {
+        Terminal::flag_full_repaint();
+    }
+}
+
+auto Basic_queue::collapse(Mouse_move_event const& e) -> bool
+{
+    if (next_ == basics_.size())
+        return false;
+    auto* const pending = std::get_if<Mouse_move_event>(&basics_.back());
+    if (pending == nullptr ||
+        &pending->receiver.get() != &e.receiver.get()) {
+        return false;
+    }
+    pending->data = e.data;
+    return true;
+}
+
+auto Basic_queue::collapse(Move_event const& e) -> bool
+{
+    auto const* const index = moves_.find(&e.receiver.get());
+    if (index == nullptr || *index < next_)
+        return false;
+    std::get<Move_event>(basics_[*index]).new_position = e.new_position;
+    return true;
+}
+
+auto Basic_queue::collapse(Resize_event const& e) -> bool
+{
+    auto const* const index = resizes_.find(&e.receiver.get());
+    if (index == nullptr || *index < next_)
+        return false;
+    std::get<Resize_event>(basics_[*index]).new_area = e.new_area;
+    return true;
+}
+
+Inbox::Inbox()  = default;
+Inbox::~Inbox() = default;
+
+auto Inbox::append(Event e) -> bool
+{
+    if (spilled_.load(std::memory_order_acquire) ||
+        !ring_.try_push(std::move(e))) {
+        // Once spilled, Events go to spill_ until the consumer empties it, so
+        // they are not taken ahead of the spilled Events posted before them.
+        auto const lock = std::lock_guard{spill_mtx_};
+        spill_.push_back(std::move(e));
+        spilled_.store(true, std::memory_order_release);
+    }
+    return !woken_.exchange(true, std::memory_order_acq_rel);
+}
+
 }  // namespace ox::detail
 
 namespace ox {
@@ -91,16 +290,24 @@ void Event_queue::send_all()
     // tree construction.
     if (System::head() == nullptr)
         return;
-    static auto mtx = std::mutex{};
-    auto const lock = std::lock_guard{mtx};
+    auto const lock = std::lock_guard{send_mutex_};
     System::set_current_queue(*this);
+    is_sending_ = true;
+    inbox_.take_all([this](Event e) { this->append(std::move(e)); });
     bool sent = basics_.send_all();
     sent      = paints_.send_all() || sent;
     deletes_.send_all();
+    is_sending_ = false;
     if (sent)
-        Terminal::flush_screen();
+        Terminal::frame_scheduler.request_frame();
 }
 
+auto Event_queue::post(Event e) -> bool { return inbox_.append(std::move(e)); }
+
+auto Event_queue::send_mutex() -> std::mutex& { return send_mutex_; }
+
+auto Event_queue::is_sending() -> bool { return is_sending_; }
+
 void Event_queue::add_to_a_queue(Paint_event e)
 {
     paints_.append(std::move(e));
@@ -7,6 +7,8 @@
 
 #include <signals_light/signal.hpp>
 
+#include <caterm/painter/detail/paint_cache.hpp>
+#include <caterm/painter/paint_cache_stats.hpp>
 #include <caterm/system/animation_engine.hpp>
 #include <caterm/system/detail/filter_send.hpp>
 #include <caterm/system/detail/focus.hpp>
@@ -17,6 +19,7 @@
 #include <caterm/system/event.hpp>
 #include <caterm/system/event_loop.hpp>
 #include <caterm/system/event_queue.hpp>
+#include <caterm/system/geometry_stats.hpp>
 #include <caterm/system/system.hpp>
 #include <caterm/terminal/key_mode.hpp>
 #include <caterm/terminal/mouse_mode.hpp>
@@ -73,6 +76,7 @@ auto System::run() -> int
     // user_input_loop_ is already stopped if you are here.
     animation_engine_.stop();
     Terminal::stop_dynamic_color_engine();
+    Terminal::frame_scheduler.stop();
     return result;
 }
 
@@ -109,7 +113,16 @@ auto System::send_event(Delete_event e) -> bool
     return true;
 }
 
-void System::post_event(Event e) { current_queue_.get().append(std::move(e)); }
+void System::post_event(Event e)
+{
+    // current_queue_ is only safe to touch while sending, under send_mutex().
+    if (Event_queue::is_sending()) {
+        current_queue_.get().append(std::move(e));
+        return;
+    }
+    if (user_input_loop_.event_queue().post(std::move(e)))
+        Terminal::wake();
+}
 
 void System::exit()
 {
@@ -137,6 +150,16 @@ void System::disable_animation(Widget& w)
     animation_engine_.unregister_widget(w);
 }
 
+auto System::paint_cache_stats() -> Paint_cache_stats
+{
+    return detail::Paint_cache::total_stats();
+}
+
+auto System::geometry_stats() -> Geometry_stats
+{
+    return detail::Basic_queue::total_geometry_stats();
+}
+
 void System::set_cursor(Cursor cursor, Point offset)
 {
     if (!cursor.is_enabled())
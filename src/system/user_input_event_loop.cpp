@@ -1,16 +1,46 @@
 #include <caterm/system/detail/user_input_event_loop.hpp>
 
+#include <utility>
+
 #include <caterm/system/event.hpp>
 #include <caterm/system/event_queue.hpp>
 #include <caterm/terminal/terminal.hpp>
 #include <caterm/widget/widget.hpp>
 
+namespace {
+
+/// Upper bound on Events read before they are sent, so a flood of input, like
+/// a large paste, still gets drawn as it comes in.
+constexpr auto max_batch = 1'024;
+
+}  // namespace
+
 namespace ox::detail {
 
 auto User_input_event_loop::run() -> int
 {
-    return loop_.run(
-        [](Event_queue& q) { q.append(ox::Terminal::read_input()); });
+    return loop_.run([this](Event_queue& q) {
+        auto event = ox::Terminal::read_ready_input();
+        if (!event.has_value()) {
+            // Woken by an Event posted from another thread, send_all() runs.
+            if (!ox::Terminal::wait_for_input())
+                return;
+            event = ox::Terminal::read_input();
+            if (!event.has_value()) {
+                loop_.exit(0);
+                return;
+            }
+        }
+        // Input that is already available is sent as one batch, so resize
+        // storms and mouse sweeps collapse in the queue and cost one frame.
+        q.append(std::move(*event));
+        for (auto count = 1; count < max_batch; ++count) {
+            event = ox::Terminal::read_ready_input();
+            if (!event.has_value())
+                break;
+            q.append(std::move(*event));
+        }
+    });
 }
 
 void User_input_event_loop::exit(int exit_code) { loop_.exit(exit_code); }
@@ -2,14 +2,21 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <ostream>
+#include <utility>
 #include <vector>
 
 #include <caterm/painter/brush.hpp>
 #include <caterm/painter/color.hpp>
 #include <caterm/painter/glyph.hpp>
+#include <caterm/terminal/detail/color_rows.hpp>
+#include <caterm/terminal/detail/glyph_search.hpp>
 #include <caterm/widget/area.hpp>
 #include <caterm/widget/point.hpp>
 
@@ -23,17 +30,187 @@ namespace {
                                : ox::Point{0, p.y + 1};
 }
 
-/// Return true if Point \p p is within the bounds of \p a.
-[[nodiscard]] auto is_within(ox::Point p, ox::Area a) -> bool
+/// Call \p changed(p, next_glyph, current_glyph) for each changed dirty cell.
+/** Visits the dirty spans of \p next, a cell is changed if it is not null and
+ *  differs from the same cell of the current Canvas, whose Glyphs start at
+ *  \p glyphs. \p changed is expected to write next_glyph to the cell, each
+ *  changed cell is re-indexed in \p colors before the call. */
+template <typename Fn>
+void for_each_change(ox::detail::Canvas const& next,
+                     ox::Glyph* glyphs,
+                     ox::detail::Color_rows& colors,
+                     Fn&& changed)
 {
-    return (p.x < a.width) && (p.y < a.height);
+    auto const width  = next.area().width;
+    auto const height = next.area().height;
+    for (auto y = 0; y < height; ++y) {
+        auto const [begin, end] = next.dirty_span(y);
+        if (begin >= end)
+            continue;
+        auto const* next_row = &*std::next(std::cbegin(next), y * width);
+        auto* current_row    = glyphs + (y * width);
+        for (auto x = begin;; ++x) {
+            x += ox::detail::find_changed(next_row + x, current_row + x,
+                                          end - x);
+            if (x == end)
+                break;
+            colors.replace(y, current_row[x], next_row[x]);
+            changed(ox::Point{x, y}, next_row[x], current_row[x]);
+        }
+    }
+}
+
+/// Return a pointer to the first Glyph of row \p y in \p c.
+[[nodiscard]] auto row_of(ox::detail::Canvas const& c, int y)
+    -> ox::Glyph const*
+{
+    return &*std::next(std::cbegin(c), y * c.area().width);
+}
+
+/// Return the Glyph \p current will hold once \p next is merged into it.
+[[nodiscard]] auto merged(ox::Glyph next, ox::Glyph current) -> ox::Glyph
+{
+    return next.symbol == U'\0' ? current : next;
+}
+
+using Row_hash = ox::detail::Scroll_search::Row_hash;
+
+/// Return the FNV-1a hash of the \p width Glyphs given by \p glyph_at(x).
+template <typename Fn>
+[[nodiscard]] auto hash_row(int width, Fn&& glyph_at) -> Row_hash
+{
+    auto hash = Row_hash{0xcbf29ce484222325};
+    for (auto x = 0; x < width; ++x) {
+        auto const g = glyph_at(x);
+        auto bits    = std::uint64_t{0};
+        std::memcpy(&bits, &g, sizeof(g));
+        hash = (hash ^ bits) * 0x100000001b3;
+    }
+    return hash;
+}
+
+/// Return true if row \p y, once merged, equals row \p source of \p current.
+[[nodiscard]] auto is_row_moved(ox::detail::Canvas const& next,
+                                ox::detail::Canvas const& current,
+                                int y,
+                                int source) -> bool
+{
+    auto const width   = next.area().width;
+    auto const* next_y = row_of(next, y);
+    auto const* curr_y = row_of(current, y);
+    auto const* curr_s = row_of(current, source);
+    for (auto x = 0; x < width; ++x) {
+        if (merged(next_y[x], curr_y[x]) != curr_s[x])
+            return false;
+    }
+    return true;
+}
+
+/// A Scroll and the number of rows it saves from being written out.
+struct Scroll_gain {
+    ox::detail::Scroll scroll;
+    int gain;
+};
+
+/// Return the Scroll within rows [top, bottom) that saves the most rows.
+[[nodiscard]] auto find_scroll_within(ox::detail::Canvas const& next,
+                                      ox::detail::Canvas const& current,
+                                      int top,
+                                      int bottom,
+                                      ox::detail::Scroll_search& search)
+    -> std::optional<Scroll_gain>
+{
+    auto const width = next.area().width;
+    auto const count = bottom - top;
+    auto& before     = search.before;
+    auto& after      = search.after;
+    before.resize(count);
+    after.resize(count);
+    for (auto i = 0; i < count; ++i) {
+        auto const* n = row_of(next, top + i);
+        auto const* c = row_of(current, top + i);
+        before[i]     = hash_row(width, [&](int x) { return c[x]; });
+        after[i] = hash_row(width, [&](int x) { return merged(n[x], c[x]); });
+    }
+
+    // A changed row that matches a row unique in current votes for the
+    // distance between them. Repeated rows, like blank lines, are ambiguous.
+    auto& sorted = search.sorted;
+    sorted.clear();
+    for (auto i = 0; i < count; ++i)
+        sorted.push_back({before[i], i});
+    std::sort(std::begin(sorted), std::end(sorted));
+    auto const unique_row = [&sorted](Row_hash h) -> int {
+        auto const iter = std::lower_bound(std::cbegin(sorted),
+                                           std::cend(sorted), std::pair{h, 0});
+        if (iter == std::cend(sorted) || iter->first != h)
+            return -1;
+        auto const after_iter = std::next(iter);
+        if (after_iter != std::cend(sorted) && after_iter->first == h)
+            return -1;
+        return iter->second;
+    };
+    auto& distances = search.distances;
+    distances.clear();
+    for (auto i = 0; i < count; ++i) {
+        if (after[i] == before[i])
+            continue;
+        if (auto const source = unique_row(after[i]); source != -1)
+            distances.push_back(source - i);
+    }
+    std::sort(std::begin(distances), std::end(distances));
+    distances.erase(std::unique(std::begin(distances), std::end(distances)),
+                    std::end(distances));
+
+    auto best = std::optional<Scroll_gain>{};
+    for (auto const d : distances) {
+        // Runs of rows i that show row i + d of current once merged.
+        auto const first = std::max(0, -d);
+        auto const last  = std::min(count, count - d);
+        auto run_begin   = first;
+        auto saved       = 0;
+        for (auto i = first; i <= last; ++i) {
+            auto const is_moved =
+                i < last && after[i] == before[i + d] &&
+                is_row_moved(next, current, top + i, top + i + d);
+            if (is_moved) {
+                if (after[i] != before[i])
+                    ++saved;
+                continue;
+            }
+            if (saved > 0) {
+                // Rows scrolled into view are blank and have to be rewritten.
+                auto const exposed_begin = d > 0 ? i : run_begin + d;
+                auto blanked             = 0;
+                for (auto e = exposed_begin; e < exposed_begin + std::abs(d);
+                     ++e) {
+                    if (after[e] == before[e])
+                        ++blanked;
+                }
+                auto const gain = saved - blanked;
+                if (!best.has_value() || gain > best->gain) {
+                    auto const region_begin = d > 0 ? run_begin : run_begin + d;
+                    auto const region_end   = d > 0 ? i + d : i;
+                    best = Scroll_gain{
+                        {top + region_begin, top + region_end, d}, gain};
+                }
+            }
+            run_begin = i + 1;
+            saved     = 0;
+        }
+    }
+    return best;
 }
 
 }  // namespace
 
 namespace ox::detail {
 
-Canvas::Canvas(ox::Area a) : buffer_(a.width * a.height, ox::Glyph{}), area_{a}
+Canvas::Canvas(ox::Area a)
+    : buffer_(a.width * a.height, ox::Glyph{}),
+      area_{a},
+      dirty_(a.height),
+      colors_{a}
 {}
 
 auto Canvas::area() const -> ox::Area { return area_; }
@@ -49,34 +226,73 @@ auto Canvas::at(ox::Point p) -> ox::Glyph&
 {
     auto const index = p.x + (p.y * area_.width);
     assert(index < (int)buffer_.size());
+    this->mark_dirty(p.y, p.x, p.x + 1);
     return buffer_[index];
 }
 
+auto Canvas::at(ox::Point p, int width) -> ox::Glyph*
+{
+    assert(width > 0 && p.x + width <= area_.width);
+    auto const index = p.x + (p.y * area_.width);
+    assert(index < (int)buffer_.size());
+    this->mark_dirty(p.y, p.x, p.x + width);
+    return buffer_.data() + index;
+}
+
+auto Canvas::dirty_span(int y) const -> Dirty_span
+{
+    assert(y < (int)dirty_.size());
+    return dirty_[y];
+}
+
+auto Canvas::dirty_row_count() const -> int { return dirty_row_count_; }
+
+auto Canvas::color_rows() const -> Color_rows const& { return colors_; }
+
+void Canvas::update_color_rows(int y)
+{
+    assert(y < area_.height);
+    colors_.update(y, buffer_.data() + (y * area_.width));
+}
+
 void Canvas::resize(ox::Area a)
 {
     if (resize_buffer_ == nullptr)
         resize_buffer_ = std::make_unique<Canvas>(a);
-    resize_buffer_->reset();
-    resize_buffer_->area_ = a;
-    resize_buffer_->buffer_.resize(a.width * a.height);
-    auto current = ox::Point{0, 0};
-    for (Glyph g : buffer_) {
-        if (::is_within(current, a))
-            resize_buffer_->at(current) = g;
-        current = next(current, area_);
+    auto& resized = *resize_buffer_;
+    // Only grows the capacity, repeated resizes reuse both buffers.
+    resized.area_ = a;
+    resized.buffer_.resize(a.width * a.height);
+    resized.dirty_.resize(a.height);
+    resized.dirty_row_count_ = 0;
+    resized.colors_.reset(a);
+
+    auto const kept_width  = std::min(area_.width, a.width);
+    auto const kept_height = std::min(area_.height, a.height);
+    for (auto y = 0; y < a.height; ++y) {
+        auto const row    = std::next(std::begin(resized.buffer_), y * a.width);
+        auto const copied = y < kept_height ? kept_width : 0;
+        std::copy_n(std::next(std::cbegin(buffer_), y * area_.width), copied,
+                    row);
+        std::fill(std::next(row, copied), std::next(row, a.width), Glyph{});
+
+        // Only the spans written to before the resize are dirty.
+        auto& span = resized.dirty_[y];
+        span       = y < kept_height ? dirty_[y] : Dirty_span{};
+        span.end   = std::min(span.end, a.width);
+        if (span.begin < span.end)
+            ++resized.dirty_row_count_;
+        if (y < kept_height)
+            resized.update_color_rows(y);
     }
-    this->swap(*resize_buffer_);
+    this->swap(resized);
 }
 
-auto Canvas::begin() -> Buffer_t::iterator { return std::begin(buffer_); }
-
 auto Canvas::begin() const -> Buffer_t::const_iterator
 {
     return std::cbegin(buffer_);
 }
 
-auto Canvas::end() -> Buffer_t::iterator { return std::end(buffer_); }
-
 auto Canvas::end() const -> Buffer_t::const_iterator
 {
     return std::cend(buffer_);
@@ -84,44 +300,130 @@ auto Canvas::end() const -> Buffer_t::const_iterator
 
 void Canvas::reset()
 {
-    std::fill(std::begin(buffer_), std::end(buffer_), Glyph{});
+    for (auto y = 0; y < area_.height; ++y) {
+        auto const [begin, end] = dirty_[y];
+        if (begin >= end)
+            continue;
+        auto const row = std::next(std::begin(buffer_), y * area_.width);
+        std::fill(std::next(row, begin), std::next(row, end), Glyph{});
+        dirty_[y] = Dirty_span{};
+    }
+    dirty_row_count_ = 0;
+}
+
+void Canvas::mark_dirty(int y, int begin, int end)
+{
+    // Spans are read by merge() without bounds checks, writes are clipped.
+    assert(y >= 0 && y < area_.height);
+    assert(begin >= 0 && begin < end && end <= area_.width);
+    auto& span = dirty_[y];
+    if (span.begin >= span.end) {
+        span = {begin, end};
+        ++dirty_row_count_;
+    }
+    else {
+        span.begin = std::min(span.begin, begin);
+        span.end   = std::max(span.end, end);
+    }
+}
+
+auto Canvas::row(int y) -> Glyph*
+{
+    assert(y <= area_.height);
+    return buffer_.data() + (y * area_.width);
 }
 
 void Canvas::swap(Canvas& x)
 {
     auto x_buf    = std::move(x.buffer_);
     auto x_area   = std::move(x.area_);
+    auto x_dirty  = std::move(x.dirty_);
     x.buffer_     = std::move(this->buffer_);
     x.area_       = std::move(this->area_);
+    x.dirty_      = std::move(this->dirty_);
     this->buffer_ = std::move(x_buf);
     this->area_   = std::move(x_area);
+    this->dirty_  = std::move(x_dirty);
+    std::swap(dirty_row_count_, x.dirty_row_count_);
+    std::swap(colors_, x.colors_);
 }
 
 void merge(Canvas const& next, Canvas& current)
 {
     assert(next.area() == current.area());
-    auto next_iter    = std::cbegin(next);
-    auto current_iter = std::begin(current);
-    for (; next_iter != std::cend(next); ++next_iter, ++current_iter) {
-        if (next_iter->symbol != U'\0' && *next_iter != *current_iter)
-            *current_iter = *next_iter;
-    }
+    for_each_change(next, current.row(0), current.colors_,
+                    [](Point, Glyph n, Glyph& c) { c = n; });
 }
 
 void merge_and_diff(Canvas const& next, Canvas& current, Canvas::Diff& diff_out)
 {
     assert(next.area() == current.area());
     diff_out.clear();
-    auto next_iter    = std::cbegin(next);
-    auto current_iter = std::begin(current);
-    auto point        = ox::Point{0, 0};
-    for (; next_iter != std::cend(next); ++next_iter, ++current_iter) {
-        if (next_iter->symbol != U'\0' && *next_iter != *current_iter) {
-            diff_out.push_back({point, *next_iter});
-            *current_iter = *next_iter;
+    for_each_change(next, current.row(0), current.colors_,
+                    [&diff_out](Point p, Glyph n, Glyph& c) {
+                        diff_out.push_back({p, n});
+                        c = n;
+                    });
+}
+
+auto find_scroll(Canvas const& next,
+                 Canvas const& current,
+                 Scroll_search& search) -> std::optional<Scroll>
+{
+    assert(next.area() == current.area());
+    auto constexpr min_gain = 2;
+    auto const height       = next.area().height;
+    auto best               = std::optional<Scroll_gain>{};
+    auto const is_dirty     = [&next](int y) {
+        auto const [begin, end] = next.dirty_span(y);
+        return begin < end;
+    };
+    for (auto y = 0; y < height;) {
+        if (!is_dirty(y)) {
+            ++y;
+            continue;
+        }
+        auto const top = y;
+        while (y < height && is_dirty(y))
+            ++y;
+        // At least min_gain moved rows and one row scrolled into view.
+        if (y - top <= min_gain)
+            continue;
+        auto const found = find_scroll_within(next, current, top, y, search);
+        if (found.has_value() &&
+            (!best.has_value() || found->gain > best->gain)) {
+            best = found;
         }
-        point = ::next(point, next.area());
     }
+    if (!best.has_value() || best->gain < min_gain)
+        return std::nullopt;
+    return best->scroll;
+}
+
+void apply_scroll(Scroll s, Canvas& next, Canvas& current)
+{
+    assert(next.area() == current.area());
+    assert(s.distance != 0 && std::abs(s.distance) < s.bottom - s.top);
+    auto const width = current.area().width;
+    auto const [exposed_begin, exposed_end] =
+        s.distance > 0 ? std::pair{s.bottom - s.distance, s.bottom}
+                       : std::pair{s.top, s.top - s.distance};
+    for (auto y = exposed_begin; y < exposed_end; ++y) {
+        for (auto x = 0; x < width; ++x) {
+            auto& glyph = next.at({x, y});
+            glyph       = merged(glyph, std::as_const(current).at({x, y}));
+        }
+    }
+    auto const row = [&current](int y) { return current.row(y); };
+    if (s.distance > 0)
+        std::copy(row(s.top + s.distance), row(s.bottom), row(s.top));
+    else {
+        std::copy_backward(row(s.top), row(s.bottom + s.distance),
+                           row(s.bottom));
+    }
+    std::fill(row(exposed_begin), row(exposed_end), Glyph{});
+    for (auto y = s.top; y < s.bottom; ++y)
+        current.update_color_rows(y);
 }
 
 void generate_color_diff(Color color,
@@ -129,11 +431,21 @@ void generate_color_diff(Color color,
                          Canvas::Diff& diff_out)
 {
     diff_out.clear();
-    auto point = ox::Point{0, 0};
-    for (Glyph g : canvas) {
-        if (g.brush.foreground == color || g.brush.background == color)
-            diff_out.push_back({point, g});
-        point = next(point, canvas.area());
+    auto const& colors = canvas.color_rows();
+    if (colors.count(color) == 0 && canvas.dirty_row_count() == 0)
+        return;
+    auto const [width, height] = canvas.area();
+    for (auto y = 0; y < height; ++y) {
+        auto const [begin, end] = canvas.dirty_span(y);
+        if (!colors.contains(y, color) && begin >= end)
+            continue;
+        auto const* glyphs = row_of(canvas, y);
+        for (auto x = 0;; ++x) {
+            x += find_color(glyphs + x, width - x, color);
+            if (x == width)
+                break;
+            diff_out.push_back({{x, y}, glyphs[x]});
+        }
     }
 }
 
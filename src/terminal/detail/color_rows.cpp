@@ -0,0 +1,48 @@
+#include <caterm/terminal/detail/color_rows.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/widget/area.hpp>
+
+namespace ox::detail {
+
+Color_rows::Color_rows(ox::Area a) { this->reset(a); }
+
+void Color_rows::reset(ox::Area a)
+{
+    auto const blank = Glyph{};
+    width_           = a.width;
+    uses_.assign((std::size_t)a.height * color_count, 0);
+    counts_.fill(0);
+    for (auto y = 0; y < a.height; ++y) {
+        uses_[index(y, blank.brush.background)] += a.width;
+        uses_[index(y, blank.brush.foreground)] += a.width;
+    }
+    if (a.width > 0) {
+        counts_[blank.brush.background.value] = a.height;
+        counts_[blank.brush.foreground.value] = a.height;
+    }
+}
+
+void Color_rows::update(int y, Glyph const* row)
+{
+    assert(y >= 0 && (std::size_t)(y + 1) * color_count <= uses_.size());
+    auto const first = std::next(std::begin(uses_), y * color_count);
+    auto const last  = std::next(first, color_count);
+    for (auto c = 0; c < color_count; ++c) {
+        if (first[c] != 0)
+            --counts_[c];
+    }
+    std::fill(first, last, 0);
+    for (auto x = 0; x < width_; ++x) {
+        this->add(y, row[x].brush.background);
+        this->add(y, row[x].brush.foreground);
+    }
+}
+
+}  // namespace ox::detail
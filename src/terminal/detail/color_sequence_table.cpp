@@ -0,0 +1,43 @@
+#include <caterm/terminal/detail/color_sequence_table.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+#include <caterm/painter/color.hpp>
+
+namespace ox::detail {
+
+Color_sequence_table::Color_sequence_table(std::string_view fallback)
+    : fallback_{make_sequence(fallback)}
+{
+    this->reset();
+}
+
+void Color_sequence_table::set(Color c, std::string_view sequence)
+{
+    table_[c.value] = make_sequence(sequence);
+}
+
+void Color_sequence_table::reset()
+{
+    std::fill(std::begin(table_), std::end(table_), fallback_);
+}
+
+auto Color_sequence_table::make_sequence(std::string_view sequence)
+    -> Sequence
+{
+    if (sequence.size() > (std::size_t)capacity) {
+        throw std::length_error{
+            "Color_sequence_table: Escape sequence is too long."};
+    }
+    auto result = Sequence{};
+    std::copy(std::begin(sequence), std::end(sequence),
+              std::begin(result.bytes));
+    result.size = static_cast<std::uint8_t>(sequence.size());
+    return result;
+}
+
+}  // namespace ox::detail
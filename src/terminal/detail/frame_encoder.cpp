@@ -0,0 +1,317 @@
+#include <caterm/terminal/detail/frame_encoder.hpp>
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+#include <esc/detail/u32_to_mb.hpp>
+#include <esc/esc.hpp>
+
+#include <caterm/painter/brush.hpp>
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/painter/trait.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/terminal/terminal_capabilities.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace {
+
+/// Return the number of decimal digits needed to print \p n.
+[[nodiscard]] auto digits(int n) -> int
+{
+    auto count = 1;
+    for (; n >= 10; n /= 10)
+        ++count;
+    return count;
+}
+
+/// Return the length in bytes of the CUP sequence that moves the cursor to p.
+[[nodiscard]] auto absolute_cost(ox::Point p) -> int
+{
+    if (p.x == 0)
+        return p.y == 0 ? 3 : 3 + digits(p.y + 1);
+    return 4 + digits(p.y + 1) + digits(p.x + 1);
+}
+
+/// Return the length in bytes of a CSI sequence with parameter \p n.
+/** As written by append_csi(), zero if \p n is zero. */
+[[nodiscard]] auto csi_cost(int n) -> int
+{
+    if (n == 0)
+        return 0;
+    return n == 1 ? 3 : 3 + digits(n);
+}
+
+/// Return the length in bytes of a relative cursor sequence of \p n cells.
+[[nodiscard]] auto relative_cost(int n) -> int { return csi_cost(n); }
+
+/// Append the decimal representation of \p n to \p out.
+void append_number(int n, std::string& out)
+{
+    auto buffer       = std::array<char, 12>{};
+    auto const result = std::to_chars(std::begin(buffer), std::end(buffer), n);
+    out.append(buffer.data(), result.ptr);
+}
+
+/// Append the CUP sequence that moves the cursor to \p p.
+void append_absolute(ox::Point p, std::string& out)
+{
+    out.append("\033[");
+    if (p.x != 0 || p.y != 0)
+        append_number(p.y + 1, out);
+    if (p.x != 0) {
+        out.push_back(';');
+        append_number(p.x + 1, out);
+    }
+    out.push_back('H');
+}
+
+/// Append the CSI sequence \p final with parameter \p n.
+/** The parameter is left out if \p n is one, its default. Nothing is
+ *  appended if \p n is zero. */
+void append_csi(int n, char final, std::string& out)
+{
+    if (n == 0)
+        return;
+    out.append("\033[");
+    if (n != 1)
+        append_number(n, out);
+    out.push_back(final);
+}
+
+/// Append the multi-byte representation of \p c to \p out.
+void append_symbol(char32_t c, std::string& out)
+{
+    if (c < 0x80) {
+        out.push_back(static_cast<char>(c));
+        return;
+    }
+    auto const [count, chars] = ::esc::detail::u32_to_mb(c);
+    out.append(chars.data(), count);
+}
+
+/// Return the length in bytes of the multi-byte representation of \p c.
+[[nodiscard]] auto symbol_size(char32_t c) -> int
+{
+    if (c < 0x80)
+        return 1;
+    auto const [count, chars] = ::esc::detail::u32_to_mb(c);
+    return static_cast<int>(count);
+}
+
+/// Return true if \p c is known to take up exactly one terminal cell.
+/** Anything outside of these ranges could be wide or zero width, the cursor
+ *  position is not assumed after writing it. */
+[[nodiscard]] auto is_narrow(char32_t c) -> bool
+{
+    return (c >= 0x20 && c < 0x7F) ||      // ASCII
+           (c >= 0xA0 && c < 0x300) ||     // Latin
+           (c >= 0x370 && c < 0x483) ||    // Greek and Cyrillic
+           (c >= 0x2190 && c < 0x2200) ||  // Arrows
+           (c >= 0x2500 && c < 0x2600) ||  // Box Drawing, Blocks, Shapes
+           (c >= 0x2800 && c < 0x2900);    // Braille
+}
+
+/// Return the number of cells starting at \p i that form a run.
+/** A run is a sequence of diff items on consecutive cells of a single row
+ *  that all hold the same narrow Glyph. */
+[[nodiscard]] auto run_length(ox::detail::Canvas::Diff const& diff,
+                              std::size_t i) -> int
+{
+    auto const [point, glyph] = diff[i];
+    if (!is_narrow(glyph.symbol))
+        return 1;
+    auto count = 1;
+    for (auto j = i + 1; j < diff.size(); ++j, ++count) {
+        auto const& [p, g] = diff[j];
+        if (p.y != point.y || p.x != point.x + count || g != glyph)
+            break;
+    }
+    return count;
+}
+
+}  // namespace
+
+namespace ox::detail {
+
+Frame_encoder::Frame_encoder(Color_sequence_fn foreground,
+                             Color_sequence_fn background)
+    : foreground_sequence_{foreground}, background_sequence_{background}
+{}
+
+void Frame_encoder::encode(Canvas::Diff const& diff,
+                           Area screen,
+                           std::string& out)
+{
+    // The terminal might have reflowed and moved the cursor on resize.
+    if (screen != screen_) {
+        screen_ = screen;
+        this->invalidate_cursor();
+    }
+    for (auto i = std::size_t{0}; i < diff.size();) {
+        auto const [point, glyph] = diff[i];
+        auto const count          = run_length(diff, i);
+        this->move_cursor(point, out);
+        this->set_brush(glyph.brush, out);
+        this->write_run(point, glyph, count, out);
+        i += count;
+    }
+}
+
+void Frame_encoder::set_cursor(Point p) { cursor_ = p; }
+
+void Frame_encoder::invalidate_cursor() { cursor_ = std::nullopt; }
+
+void Frame_encoder::invalidate_brush()
+{
+    foreground_ = std::nullopt;
+    background_ = std::nullopt;
+}
+
+void Frame_encoder::invalidate()
+{
+    this->invalidate_cursor();
+    this->invalidate_brush();
+}
+
+void Frame_encoder::set_capabilities(Terminal_capabilities c)
+{
+    capabilities_ = c;
+}
+
+void Frame_encoder::move_cursor(Point p, std::string& out)
+{
+    if (cursor_ == p)
+        return;
+    if (!cursor_.has_value()) {
+        append_absolute(p, out);
+        cursor_ = p;
+        return;
+    }
+    auto const dx = p.x - cursor_->x;
+    auto const dy = p.y - cursor_->y;
+
+    // Carriage return and line feeds are only used together, the column a line
+    // feed leaves the cursor at depends on the terminal's ONLCR setting.
+    auto const horizontal_cost = [&] {
+        if (dx == 0)
+            return 0;
+        return p.x == 0 ? 1 : relative_cost(std::abs(dx));
+    }();
+    auto const use_line_feeds = dy > 0 && p.x == 0 && dy < relative_cost(dy);
+    auto const vertical_cost =
+        use_line_feeds ? dy : relative_cost(std::abs(dy));
+
+    if (absolute_cost(p) <= horizontal_cost + vertical_cost)
+        append_absolute(p, out);
+    else {
+        if (p.x == 0 && dx != 0)
+            out.push_back('\r');
+        else
+            append_csi(std::abs(dx), dx > 0 ? 'C' : 'D', out);
+        if (use_line_feeds)
+            out.append(dy, '\n');
+        else
+            append_csi(std::abs(dy), dy > 0 ? 'B' : 'A', out);
+    }
+    cursor_ = p;
+}
+
+void Frame_encoder::scroll(Scroll s, std::string& out)
+{
+    // New rows are erased with the active background Color.
+    this->set_brush(Brush{}, out);
+    out.append("\033[");
+    append_number(s.top + 1, out);
+    out.push_back(';');
+    append_number(s.bottom, out);
+    out.push_back('r');
+    // DECSTBM moves the cursor, to the home position on most terminals.
+    this->invalidate_cursor();
+    if (s.distance > 0) {
+        this->move_cursor({0, s.bottom - 1}, out);
+        for (auto i = 0; i < s.distance; ++i)
+            out.append("\033D");
+    }
+    else {
+        this->move_cursor({0, s.top}, out);
+        for (auto i = 0; i < -s.distance; ++i)
+            out.append("\033M");
+    }
+    out.append("\033[r");
+    this->invalidate_cursor();
+}
+
+void Frame_encoder::set_brush(Brush b, std::string& out)
+{
+    if (::esc::traits() != b.traits) {
+        out.append(::esc::escape(b.traits));
+        // Trait sequences can reset every SGR attribute, including colors.
+        this->invalidate_brush();
+    }
+    if (foreground_ != b.foreground) {
+        out.append(foreground_sequence_(b.foreground));
+        foreground_ = b.foreground;
+    }
+    if (background_ != b.background) {
+        out.append(background_sequence_(b.background));
+        background_ = b.background;
+    }
+}
+
+void Frame_encoder::write_run(Point p, Glyph g, int count, std::string& out)
+{
+    enum class Method { Literal, Repeat, Erase, Erase_line };
+
+    auto const end_x       = p.x + count;
+    auto const is_line_end = end_x == screen_.width;
+    auto const size        = symbol_size(g.symbol);
+    auto const is_erasable = capabilities_.background_color_erase &&
+                             g.symbol == U' ' &&
+                             g.brush.traits == Traits{Trait::None};
+
+    auto method = Method::Literal;
+    auto cost   = count * size;
+
+    auto const consider = [&](Method m, int c) {
+        if (c < cost) {
+            method = m;
+            cost   = c;
+        }
+    };
+    if (capabilities_.repeat && count > 1)
+        consider(Method::Repeat, size + csi_cost(count - 1));
+    if (is_erasable && is_line_end)
+        consider(Method::Erase_line, 3);
+    // ECH leaves the cursor at p, it has to be moved past the run after.
+    if (is_erasable && !is_line_end)
+        consider(Method::Erase, csi_cost(count) + relative_cost(count));
+
+    switch (method) {
+        case Method::Literal:
+            for (auto i = 0; i < count; ++i)
+                append_symbol(g.symbol, out);
+            break;
+        case Method::Repeat:
+            append_symbol(g.symbol, out);
+            append_csi(count - 1, 'b', out);
+            break;
+        case Method::Erase: append_csi(count, 'X', out); break;
+        case Method::Erase_line: out.append("\033[K"); break;
+    }
+
+    if (method == Method::Erase || method == Method::Erase_line)
+        cursor_ = p;
+    // Writing to the last column leaves the cursor in a pending wrap state.
+    else if (is_narrow(g.symbol) && !is_line_end)
+        cursor_ = Point{end_x, p.y};
+    else
+        cursor_ = std::nullopt;
+}
+
+}  // namespace ox::detail
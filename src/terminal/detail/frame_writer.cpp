@@ -0,0 +1,115 @@
+#include <caterm/terminal/detail/frame_writer.hpp>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <caterm/terminal/frame_stats.hpp>
+#include <caterm/terminal/terminal_backend.hpp>
+
+namespace ox::detail {
+
+Frame_writer::~Frame_writer() { this->stop(); }
+
+void Frame_writer::start(Terminal_backend& backend)
+{
+    auto const lock = std::lock_guard{mtx_};
+    if (thread_.joinable())
+        return;
+    backend_ = &backend;
+    exit_    = false;
+    thread_  = std::thread{[this] { this->loop(); }};
+}
+
+void Frame_writer::stop()
+{
+    {
+        auto const lock = std::lock_guard{mtx_};
+        if (!thread_.joinable())
+            return;
+        exit_ = true;
+    }
+    changed_.notify_all();
+    thread_.join();
+}
+
+auto Frame_writer::is_full() const -> bool
+{
+    auto const lock = std::lock_guard{mtx_};
+    return !pending_.empty();
+}
+
+void Frame_writer::submit(std::string& bytes)
+{
+    auto lock = std::unique_lock{mtx_};
+    if (!thread_.joinable()) {
+        lock.unlock();
+        if (backend_ != nullptr)
+            this->write(*backend_, bytes);
+        bytes.clear();
+        return;
+    }
+    if (pending_.empty())
+        std::swap(pending_, bytes);
+    else {
+        pending_.append(bytes);
+        bytes.clear();
+    }
+    lock.unlock();
+    changed_.notify_all();
+}
+
+void Frame_writer::wait_until_ready() const
+{
+    auto lock = std::unique_lock{mtx_};
+    changed_.wait(lock, [this] { return pending_.empty(); });
+}
+
+void Frame_writer::record_dropped()
+{
+    auto const lock = std::lock_guard{mtx_};
+    ++total_.dropped;
+}
+
+auto Frame_writer::last_stats() const -> Frame_stats
+{
+    auto const lock = std::lock_guard{mtx_};
+    return last_;
+}
+
+auto Frame_writer::total_stats() const -> Frame_stats
+{
+    auto const lock = std::lock_guard{mtx_};
+    return total_;
+}
+
+void Frame_writer::write(Terminal_backend& backend, std::string const& bytes)
+{
+    auto const syscalls = backend.write(bytes);
+    auto const lock     = std::lock_guard{mtx_};
+    last_               = {1, bytes.size(), syscalls, 0};
+    total_.frames += 1;
+    total_.bytes += bytes.size();
+    total_.syscalls += syscalls;
+}
+
+void Frame_writer::loop()
+{
+    auto lock = std::unique_lock{mtx_};
+    while (true) {
+        changed_.wait(lock, [this] { return exit_ || !pending_.empty(); });
+        // Anything submitted before stop() is still written.
+        if (pending_.empty())
+            break;
+        std::swap(pending_, writing_);
+        auto& backend = *backend_;
+        lock.unlock();
+        changed_.notify_all();
+        this->write(backend, writing_);
+        writing_.clear();
+        lock.lock();
+    }
+}
+
+}  // namespace ox::detail
@@ -0,0 +1,249 @@
+#include <caterm/terminal/detail/glyph_search.hpp>
+
+#include <cstddef>
+
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#    define CATERM_GLYPH_SEARCH_X86
+#    include <immintrin.h>
+#endif
+
+// The vector kernels compare Glyphs bitwise, which is only equivalent to
+// operator== if there is no padding.
+static_assert(sizeof(ox::Glyph) == 8);
+static_assert(sizeof(ox::Brush) == 4);
+static_assert(offsetof(ox::Glyph, brush) == 4);
+
+namespace {
+
+using ox::Color;
+using ox::Glyph;
+using ox::detail::Glyph_search_isa;
+
+[[nodiscard]] auto find_changed_scalar(Glyph const* next,
+                                       Glyph const* current,
+                                       int count) -> int
+{
+    for (auto i = 0; i < count; ++i) {
+        if (next[i].symbol != U'\0' && next[i] != current[i])
+            return i;
+    }
+    return count;
+}
+
+[[nodiscard]] auto find_color_scalar(Glyph const* glyphs, int count, Color c)
+    -> int
+{
+    for (auto i = 0; i < count; ++i) {
+        auto const& brush = glyphs[i].brush;
+        if (brush.foreground == c || brush.background == c)
+            return i;
+    }
+    return count;
+}
+
+#ifdef CATERM_GLYPH_SEARCH_X86
+
+/// Return a mask with a bit set in each of the \p n Glyph's Color bytes.
+/** \p n Glyphs are compared with one byte per bit, as from movemask_epi8. */
+[[nodiscard]] constexpr auto color_byte_mask(int n) -> unsigned
+{
+    auto constexpr brush  = offsetof(Glyph, brush);
+    auto constexpr bg     = brush + offsetof(ox::Brush, background);
+    auto constexpr fg     = brush + offsetof(ox::Brush, foreground);
+    auto constexpr single = (1u << bg) | (1u << fg);
+    auto mask             = 0u;
+    for (auto i = 0; i < n; ++i)
+        mask |= single << (i * sizeof(Glyph));
+    return mask;
+}
+
+/// Return the Glyph index for the first set bit from a pair-per-Glyph mask.
+[[nodiscard]] auto first_pair(unsigned mask) -> int
+{
+    return __builtin_ctz(mask) / 2;
+}
+
+// Each 32 bit lane comparison gives one bit from movemask_ps, two per Glyph;
+// the low bit of each pair is the symbol, the high bit is the Brush. A Glyph
+// is skipped if both bits are equal, or if the symbol is null.
+
+__attribute__((target("sse2"))) auto find_changed_sse2(Glyph const* next,
+                                                       Glyph const* current,
+                                                       int count) -> int
+{
+    auto const zero = _mm_setzero_si128();
+    auto i          = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto const* n = reinterpret_cast<__m128i const*>(next + i);
+        auto const* c = reinterpret_cast<__m128i const*>(current + i);
+        auto const n0 = _mm_loadu_si128(n);
+        auto const n1 = _mm_loadu_si128(n + 1);
+        auto const eq =
+            (unsigned)_mm_movemask_ps(_mm_castsi128_ps(
+                _mm_cmpeq_epi32(n0, _mm_loadu_si128(c)))) |
+            (unsigned)_mm_movemask_ps(_mm_castsi128_ps(
+                _mm_cmpeq_epi32(n1, _mm_loadu_si128(c + 1))))
+                << 4;
+        auto const null =
+            (unsigned)_mm_movemask_ps(
+                _mm_castsi128_ps(_mm_cmpeq_epi32(n0, zero))) |
+            (unsigned)_mm_movemask_ps(
+                _mm_castsi128_ps(_mm_cmpeq_epi32(n1, zero)))
+                << 4;
+        auto const changed = ~((eq & (eq >> 1)) | null) & 0x55u;
+        if (changed != 0)
+            return i + first_pair(changed);
+    }
+    return i + find_changed_scalar(next + i, current + i, count - i);
+}
+
+__attribute__((target("sse2"))) auto find_color_sse2(Glyph const* glyphs,
+                                                     int count,
+                                                     Color c) -> int
+{
+    auto const key = _mm_set1_epi8((char)c.value);
+    auto i         = 0;
+    for (; i + 2 <= count; i += 2) {
+        auto const g =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(glyphs + i));
+        auto const match = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(g, key)) &
+                           color_byte_mask(2);
+        if (match != 0)
+            return i + (__builtin_ctz(match) / (int)sizeof(Glyph));
+    }
+    return i + find_color_scalar(glyphs + i, count - i, c);
+}
+
+__attribute__((target("avx2"))) auto find_changed_avx2(Glyph const* next,
+                                                       Glyph const* current,
+                                                       int count) -> int
+{
+    auto const zero = _mm256_setzero_si256();
+    auto i          = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto const* n = reinterpret_cast<__m256i const*>(next + i);
+        auto const* c = reinterpret_cast<__m256i const*>(current + i);
+        auto const n0 = _mm256_loadu_si256(n);
+        auto const n1 = _mm256_loadu_si256(n + 1);
+        auto const eq =
+            (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(
+                _mm256_cmpeq_epi32(n0, _mm256_loadu_si256(c)))) |
+            (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(
+                _mm256_cmpeq_epi32(n1, _mm256_loadu_si256(c + 1))))
+                << 8;
+        auto const null =
+            (unsigned)_mm256_movemask_ps(
+                _mm256_castsi256_ps(_mm256_cmpeq_epi32(n0, zero))) |
+            (unsigned)_mm256_movemask_ps(
+                _mm256_castsi256_ps(_mm256_cmpeq_epi32(n1, zero)))
+                << 8;
+        auto const changed = ~((eq & (eq >> 1)) | null) & 0x5555u;
+        if (changed != 0)
+            return i + first_pair(changed);
+    }
+    return i + find_changed_sse2(next + i, current + i, count - i);
+}
+
+__attribute__((target("avx2"))) auto find_color_avx2(Glyph const* glyphs,
+                                                     int count,
+                                                     Color c) -> int
+{
+    auto const key = _mm256_set1_epi8((char)c.value);
+    auto i         = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto const g =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(glyphs + i));
+        auto const match =
+            (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(g, key)) &
+            color_byte_mask(4);
+        if (match != 0)
+            return i + (__builtin_ctz(match) / (int)sizeof(Glyph));
+    }
+    return i + find_color_sse2(glyphs + i, count - i, c);
+}
+
+#endif  // CATERM_GLYPH_SEARCH_X86
+
+/// Function pointers for the currently used kernels.
+struct Kernels {
+    Glyph_search_isa isa;
+    int (*find_changed)(Glyph const*, Glyph const*, int);
+    int (*find_color)(Glyph const*, int, Color);
+};
+
+[[nodiscard]] auto kernels_for(Glyph_search_isa isa) -> Kernels
+{
+    switch (isa) {
+#ifdef CATERM_GLYPH_SEARCH_X86
+        case Glyph_search_isa::AVX2:
+            return {isa, &find_changed_avx2, &find_color_avx2};
+        case Glyph_search_isa::SSE2:
+            return {isa, &find_changed_sse2, &find_color_sse2};
+#endif
+        default: return {Glyph_search_isa::Scalar, &find_changed_scalar,
+                         &find_color_scalar};
+    }
+}
+
+[[nodiscard]] auto widest_supported() -> Glyph_search_isa
+{
+    for (auto isa : {Glyph_search_isa::AVX2, Glyph_search_isa::SSE2}) {
+        if (ox::detail::is_supported(isa))
+            return isa;
+    }
+    return Glyph_search_isa::Scalar;
+}
+
+/// Return the kernels in use, initialized on first use to the widest ISA.
+[[nodiscard]] auto active() -> Kernels&
+{
+    static auto kernels = kernels_for(widest_supported());
+    return kernels;
+}
+
+}  // namespace
+
+namespace ox::detail {
+
+auto find_changed(Glyph const* next, Glyph const* current, int count) -> int
+{
+    return active().find_changed(next, current, count);
+}
+
+auto find_color(Glyph const* glyphs, int count, Color c) -> int
+{
+    return active().find_color(glyphs, count, c);
+}
+
+auto glyph_search_isa() -> Glyph_search_isa { return active().isa; }
+
+auto is_supported(Glyph_search_isa isa) -> bool
+{
+    switch (isa) {
+        case Glyph_search_isa::Scalar: return true;
+#ifdef CATERM_GLYPH_SEARCH_X86
+        // May be called from a static initializer, before libgcc's.
+        case Glyph_search_isa::SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case Glyph_search_isa::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+auto set_glyph_search_isa(Glyph_search_isa isa) -> bool
+{
+    if (!is_supported(isa))
+        return false;
+    active() = kernels_for(isa);
+    return true;
+}
+
+}  // namespace ox::detail
@@ -1,5 +1,7 @@
 #include <caterm/terminal/detail/screen_buffers.hpp>
 
+#include <optional>
+
 #include <caterm/terminal/detail/canvas.hpp>
 #include <caterm/widget/area.hpp>
 
@@ -23,6 +25,16 @@ auto Screen_buffers::merge_and_diff() -> Canvas::Diff const&
     return diff_;
 }
 
+auto Screen_buffers::find_scroll() -> std::optional<Scroll>
+{
+    return ::ox::detail::find_scroll(next, current, scroll_search_);
+}
+
+void Screen_buffers::apply_scroll(Scroll s)
+{
+    ::ox::detail::apply_scroll(s, next, current);
+}
+
 auto Screen_buffers::generate_color_diff(Color c) -> Canvas::Diff const&
 {
     ::ox::detail::generate_color_diff(c, current, diff_);
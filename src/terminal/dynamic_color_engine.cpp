@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <iterator>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -15,24 +17,25 @@ namespace ox {
 void Dynamic_color_engine::register_color(Color color,
                                           Dynamic_color const& dynamic)
 {
-    auto const lock = this->Lockable::lock();
-    data_.push_back({color, dynamic, Clock_t::now()});
+    auto const lock     = this->Lockable::lock();
+    auto const interval = std::max(dynamic.interval, Interval_t{1});
+    data_[color.value]  = {dynamic, next_id_};
+    deadlines_.push(Clock_t::now() + interval, Deadline{color, next_id_++});
+    this->drop_stale_deadlines();
 }
 
 void Dynamic_color_engine::unregister_color(Color color)
 {
     auto const lock = this->Lockable::lock();
-    auto const iter =
-        std::find_if(std::cbegin(data_), std::cend(data_),
-                     [color](auto const& data) { return data.color == color; });
-    if (iter != std::cend(data_))
-        data_.erase(iter);
+    data_.erase(color.value);
+    this->drop_stale_deadlines();
 }
 
 void Dynamic_color_engine::clear()
 {
     auto const lock = this->Lockable::lock();
     data_.clear();
+    deadlines_.clear();
 }
 
 auto Dynamic_color_engine::is_empty() const -> bool
@@ -41,6 +44,21 @@ auto Dynamic_color_engine::is_empty() const -> bool
     return data_.empty();
 }
 
+auto Dynamic_color_engine::deadline_count() const -> std::size_t
+{
+    auto const lock = this->Lockable::lock();
+    return deadlines_.size();
+}
+
+auto Dynamic_color_engine::earliest_deadline() const
+    -> std::optional<Time_point>
+{
+    auto const lock = this->Lockable::lock();
+    if (deadlines_.is_empty())
+        return std::nullopt;
+    return deadlines_.top().deadline;
+}
+
 void Dynamic_color_engine::start()
 {
     loop_.run_async([this](Event_queue& q) { this->loop_function(q); });
@@ -52,37 +70,34 @@ void Dynamic_color_engine::stop()
     loop_.wait();
 }
 
+auto Dynamic_color_engine::is_stale(Deadline const& d) const -> bool
+{
+    auto const iter = data_.find(d.color.value);
+    return iter == std::end(data_) || iter->second.id != d.id;
+}
+
+void Dynamic_color_engine::drop_stale_deadlines()
+{
+    if (deadlines_.size() > 2 * data_.size())
+        deadlines_.erase_if([this](Deadline const& d) { return is_stale(d); });
+}
+
 auto Dynamic_color_engine::get_dynamic_color_event() -> Dynamic_color_event
 {
-    auto processed = Dynamic_color_event::Processed_colors{};
-    if (data_.empty()) {
-        timer_.set_interval(default_interval);
-        return Dynamic_color_event{processed};
-    }
-    {
-        auto const lock    = this->Lockable::lock();
-        auto next_interval = [&, this] {
-            return std::min_element(std::cbegin(data_), std::cend(data_),
-                                    [](auto const& a, auto const& b) {
-                                        return a.dynamic.interval <
-                                               b.dynamic.interval;
-                                    })
-                ->dynamic.interval;
-        }();
-        auto const now = Clock_t::now();
-        for (auto& data : data_) {
-            auto const time_left = std::chrono::duration_cast<Interval_t>(
-                data.dynamic.interval - (now - data.last_event_time));
-            if (time_left <= Interval_t{0}) {
-                data.last_event_time = now;
-                processed.push_back({data.color, data.dynamic.get_value()});
-            }
-            else {
-                next_interval = std::min(next_interval, time_left);
-            }
-        }
-        timer_.set_interval(next_interval);
-    }
+    auto processed  = Dynamic_color_event::Processed_colors{};
+    auto const lock = this->Lockable::lock();
+    auto const now  = Clock_t::now();
+    auto const fire = [&](Deadline const& due) -> std::optional<Interval_t> {
+        auto const iter = data_.find(due.color.value);
+        if (iter == std::end(data_) || iter->second.id != due.id)
+            return std::nullopt;  // Unregistered or replaced since.
+        auto& dynamic = iter->second.dynamic;
+        processed.push_back({due.color, dynamic.get_value()});
+        return std::max(dynamic.interval, Interval_t{1});
+    };
+    deadlines_.fire_due(now, fire);
+    // Capped, so a Color registered in the meantime is not kept waiting.
+    timer_.set_interval(deadlines_.time_until_next(now, default_interval));
     return Dynamic_color_event{std::move(processed)};
 }
 
@@ -0,0 +1,128 @@
+#include <caterm/terminal/frame_scheduler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <caterm/common/fps.hpp>
+#include <caterm/system/event.hpp>
+#include <caterm/system/event_queue.hpp>
+#include <caterm/system/system.hpp>
+#include <caterm/terminal/terminal.hpp>
+
+namespace ox {
+
+Frame_scheduler::~Frame_scheduler()
+{
+    if (thread_.joinable())
+        this->stop();
+}
+
+void Frame_scheduler::set_max_fps(FPS fps) { max_fps_ = fps.value; }
+
+auto Frame_scheduler::max_fps() const -> FPS { return FPS{max_fps_}; }
+
+void Frame_scheduler::set_adaptive_pacing(bool enable) { adaptive_ = enable; }
+
+auto Frame_scheduler::is_adaptive_pacing() const -> bool { return adaptive_; }
+
+void Frame_scheduler::request_frame()
+{
+    if (!blocked_ && Clock_t::now() - last_frame_ >= this->period()) {
+        if (!this->flush())
+            this->defer();
+        return;
+    }
+    pending_ = true;
+    this->defer();
+}
+
+void Frame_scheduler::stop()
+{
+    {
+        auto const lock = std::lock_guard{Event_queue::send_mutex()};
+        exit_           = true;
+    }
+    deferred_.notify_one();
+    if (thread_.joinable())
+        thread_.join();
+
+    // Made here and not by the exiting thread, which could only defer a frame
+    // dropped by a full writer to itself. Retried until the writer takes it.
+    auto lock = std::unique_lock{Event_queue::send_mutex()};
+    while (pending_) {
+        lock.unlock();
+        Terminal::wait_for_output();
+        lock.lock();
+        blocked_ = false;
+        this->flush();
+    }
+}
+
+auto Frame_scheduler::period() const -> Duration_t
+{
+    auto const fps = max_fps_.load();
+    if (fps == 0)
+        return Duration_t::zero();
+    auto const cap = fps_to_period<Duration_t>(FPS{fps});
+    return adaptive_ ? std::max(cap, frame_cost_ * 2) : cap;
+}
+
+auto Frame_scheduler::flush() -> bool
+{
+    pending_ = false;
+    if (System::head() == nullptr)
+        return true;
+    auto const start = Clock_t::now();
+    if (!Terminal::flush_screen()) {
+        pending_ = true;
+        blocked_ = true;
+        return false;
+    }
+    last_frame_ = start;
+    // Exponential moving average, a single slow frame won't stall the rate.
+    frame_cost_ = (frame_cost_ * 7 + (Clock_t::now() - start)) / 8;
+    return true;
+}
+
+void Frame_scheduler::defer()
+{
+    if (!thread_.joinable()) {
+        exit_   = false;
+        thread_ = std::thread{[this] { this->deferred_loop(); }};
+    }
+    deferred_.notify_one();
+}
+
+void Frame_scheduler::deferred_loop()
+{
+    auto lock = std::unique_lock{Event_queue::send_mutex()};
+    // The event loops keep sending while the terminal catches up.
+    auto const wait_for_output = [&] {
+        if (!blocked_)
+            return;
+        lock.unlock();
+        Terminal::wait_for_output();
+        lock.lock();
+        blocked_ = false;
+    };
+    while (true) {
+        deferred_.wait(lock, [this] { return pending_ || exit_; });
+        if (exit_)
+            break;
+        wait_for_output();
+        // Requests that arrive while waiting are merged into this frame, and a
+        // frame flushed immediately in the meantime resets the deadline.
+        while (pending_ && !exit_ &&
+               Clock_t::now() < last_frame_ + this->period()) {
+            deferred_.wait_until(lock, last_frame_ + this->period());
+        }
+        // A dropped frame stays pending and blocked_, the next pass waits
+        // for the writer and retries it.
+        if (pending_ && !exit_)
+            this->flush();
+    }
+}
+
+}  // namespace ox
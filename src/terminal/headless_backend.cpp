@@ -0,0 +1,427 @@
+#include <caterm/terminal/headless_backend.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <esc/event.hpp>
+
+#include <caterm/terminal/terminal_capabilities.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace {
+
+auto constexpr escape = '\033';
+
+/// Return the number of bytes in a UTF-8 sequence starting with \p lead.
+[[nodiscard]] auto utf8_length(unsigned char lead) -> std::size_t
+{
+    if (lead < 0x80)
+        return 1;
+    if ((lead >> 5) == 0x6)
+        return 2;
+    if ((lead >> 4) == 0xE)
+        return 3;
+    if ((lead >> 3) == 0x1E)
+        return 4;
+    return 1;  // Invalid, taken as a single byte.
+}
+
+/// Decode the UTF-8 sequence \p bytes, which is utf8_length() long.
+[[nodiscard]] auto utf8_decode(std::string_view bytes) -> char32_t
+{
+    auto const lead = static_cast<unsigned char>(bytes[0]);
+    if (bytes.size() == 1)
+        return lead < 0x80 ? lead : U'?';
+    auto result = static_cast<char32_t>(lead & (0x7F >> bytes.size()));
+    for (auto i = std::size_t{1}; i < bytes.size(); ++i)
+        result = (result << 6) | (static_cast<unsigned char>(bytes[i]) & 0x3F);
+    return result;
+}
+
+/// Return the number of cells \p symbol takes up, one or two.
+[[nodiscard]] auto cell_width(char32_t symbol) -> int
+{
+    return ::wcwidth(static_cast<wchar_t>(symbol)) == 2 ? 2 : 1;
+}
+
+/// Return parameter \p i, or \p fallback if it is missing or zero.
+[[nodiscard]] auto parameter(std::vector<int> const& parameters,
+                             std::size_t i,
+                             int fallback) -> int
+{
+    return (i < parameters.size() && parameters[i] != 0) ? parameters[i]
+                                                          : fallback;
+}
+
+}  // namespace
+
+namespace ox {
+
+Headless_backend::Headless_backend(Area a)
+    : area_{a}, screen_(a.width * a.height)
+{}
+
+void Headless_backend::initialize(Mouse_mode, Key_mode, Signals) {}
+
+void Headless_backend::uninitialize() {}
+
+auto Headless_backend::area() const -> Area { return area_; }
+
+auto Headless_backend::write(std::string_view bytes) -> std::size_t
+{
+    bytes_ += bytes.size();
+    ++writes_;
+    unparsed_.append(bytes);
+    auto view = std::string_view{unparsed_};
+    while (!view.empty()) {
+        auto const used = this->parse_one(view);
+        if (used == 0)
+            break;
+        view.remove_prefix(used);
+    }
+    // Keep an incomplete sequence for the next write.
+    unparsed_.erase(0, unparsed_.size() - view.size());
+    return 1;
+}
+
+auto Headless_backend::read() -> std::optional<::esc::Event>
+{
+    if (input_.empty())
+        return std::nullopt;
+    auto event = std::move(input_.front());
+    input_.pop_front();
+    return event;
+}
+
+auto Headless_backend::read_ready() -> std::optional<::esc::Event>
+{
+    return this->read();
+}
+
+auto Headless_backend::color_palette_size() const -> std::uint16_t
+{
+    return 256;
+}
+
+auto Headless_backend::has_true_color() const -> bool { return true; }
+
+auto Headless_backend::capabilities() const -> Terminal_capabilities
+{
+    return {true, true};
+}
+
+void Headless_backend::push_input(::esc::Event e)
+{
+    input_.push_back(std::move(e));
+}
+
+void Headless_backend::resize(Area a)
+{
+    auto resized = std::vector<Cell>(a.width * a.height);
+    for (auto y = 0; y < std::min(a.height, area_.height); ++y) {
+        for (auto x = 0; x < std::min(a.width, area_.width); ++x)
+            resized[y * a.width + x] = this->at({x, y});
+    }
+    screen_        = std::move(resized);
+    area_          = a;
+    scroll_top_    = 0;
+    scroll_bottom_ = a.height;
+    cursor_ = {std::min(cursor_.x, a.width - 1),
+               std::min(cursor_.y, a.height - 1)};
+    wrap_pending_ = false;
+    input_.push_back(::esc::Window_resize{a});
+}
+
+auto Headless_backend::at(Point p) const -> Cell const&
+{
+    assert(p.x < area_.width && p.y < area_.height);
+    return screen_[p.y * area_.width + p.x];
+}
+
+auto Headless_backend::row(int y) const -> std::u32string
+{
+    auto result = std::u32string{};
+    for (auto x = 0; x < area_.width; ++x) {
+        if (auto const symbol = this->at({x, y}).symbol; symbol != U'\0')
+            result.push_back(symbol);
+    }
+    return result;
+}
+
+auto Headless_backend::cursor() const -> Point { return cursor_; }
+
+auto Headless_backend::is_cursor_visible() const -> bool
+{
+    return cursor_visible_;
+}
+
+auto Headless_backend::bytes_written() const -> std::size_t { return bytes_; }
+
+auto Headless_backend::write_count() const -> std::size_t { return writes_; }
+
+auto Headless_backend::cell(Point p) -> Cell&
+{
+    assert(p.x < area_.width && p.y < area_.height);
+    return screen_[p.y * area_.width + p.x];
+}
+
+auto Headless_backend::parse_one(std::string_view bytes) -> std::size_t
+{
+    auto const c = bytes[0];
+    if (c == escape) {
+        if (bytes.size() < 2)
+            return 0;
+        if (bytes[1] == '[') {
+            auto const used = this->parse_csi(bytes.substr(2));
+            return used == 0 ? 0 : used + 2;
+        }
+        if (bytes[1] == ']') {  // OSC, ignored up to BEL or ST.
+            for (auto i = std::size_t{2}; i < bytes.size(); ++i) {
+                if (bytes[i] == '\a')
+                    return i + 1;
+                if (bytes[i] == escape && i + 1 < bytes.size())
+                    return i + 2;
+            }
+            return 0;
+        }
+        if (bytes[1] == 'D')
+            this->line_feed();
+        else if (bytes[1] == 'M')
+            this->reverse_index();
+        wrap_pending_ = false;
+        return 2;  // Other two byte sequences are ignored.
+    }
+    if (c == '\r') {
+        cursor_.x     = 0;
+        wrap_pending_ = false;
+        return 1;
+    }
+    if (c == '\n') {
+        this->line_feed();
+        wrap_pending_ = false;
+        return 1;
+    }
+    if (static_cast<unsigned char>(c) < 0x20 || c == 0x7F)
+        return 1;  // Other control characters are ignored.
+    auto const length = utf8_length(static_cast<unsigned char>(c));
+    if (bytes.size() < length)
+        return 0;
+    this->put(utf8_decode(bytes.substr(0, length)));
+    return length;
+}
+
+auto Headless_backend::parse_csi(std::string_view bytes) -> std::size_t
+{
+    auto parameters     = std::vector<int>{};
+    auto private_marker = false;
+    auto current        = std::optional<int>{};
+    for (auto i = std::size_t{0}; i < bytes.size(); ++i) {
+        auto const c = bytes[i];
+        if (c >= '0' && c <= '9')
+            current = current.value_or(0) * 10 + (c - '0');
+        else if (c == ';') {
+            parameters.push_back(current.value_or(0));
+            current = std::nullopt;
+        }
+        else if (c == '?' && i == 0)
+            private_marker = true;
+        else if (c >= 0x40 && c <= 0x7E) {
+            if (current.has_value() || !parameters.empty())
+                parameters.push_back(current.value_or(0));
+            this->apply_csi(c, private_marker, parameters);
+            return i + 1;
+        }
+        // Intermediate bytes are ignored.
+    }
+    return 0;
+}
+
+void Headless_backend::apply_csi(char final,
+                                 bool private_marker,
+                                 std::vector<int> const& parameters)
+{
+    auto const clamp_x = [this](int x) {
+        return std::clamp(x, 0, area_.width - 1);
+    };
+    auto const clamp_y = [this](int y) {
+        return std::clamp(y, 0, area_.height - 1);
+    };
+    if (private_marker) {
+        if (parameter(parameters, 0, 0) == 25 && (final == 'h' || final == 'l'))
+            cursor_visible_ = final == 'h';
+        return;
+    }
+    auto const n = parameter(parameters, 0, 1);
+    switch (final) {
+        case 'H':
+        case 'f':
+            cursor_ = {clamp_x(parameter(parameters, 1, 1) - 1),
+                       clamp_y(n - 1)};
+            break;
+        case 'A': cursor_.y = clamp_y(cursor_.y - n); break;
+        case 'B': cursor_.y = clamp_y(cursor_.y + n); break;
+        case 'C': cursor_.x = clamp_x(cursor_.x + n); break;
+        case 'D': cursor_.x = clamp_x(cursor_.x - n); break;
+        case 'm': this->apply_sgr(parameters); break;
+        case 'S': this->scroll(n); break;
+        case 'T': this->scroll(-n); break;
+        case 'r': {
+            auto const top    = parameter(parameters, 0, 1) - 1;
+            auto const bottom = parameter(parameters, 1, area_.height);
+            if (top < bottom - 1 && bottom <= area_.height) {
+                scroll_top_    = top;
+                scroll_bottom_ = bottom;
+            }
+            cursor_ = {0, 0};
+        } break;
+        case 'J': {
+            auto const mode  = parameters.empty() ? 0 : parameters[0];
+            auto const first = mode == 0 ? cursor_.y + 1 : 0;
+            auto const last  = mode == 1 ? cursor_.y : area_.height;
+            if (mode == 0)
+                this->erase(cursor_.y, cursor_.x, area_.width);
+            if (mode == 1)
+                this->erase(cursor_.y, 0, cursor_.x + 1);
+            for (auto y = first; y < last; ++y)
+                this->erase(y, 0, area_.width);
+        } break;
+        case 'K': {
+            auto const mode  = parameters.empty() ? 0 : parameters[0];
+            auto const begin = mode == 0 ? cursor_.x : 0;
+            auto const end   = mode == 1 ? cursor_.x + 1 : area_.width;
+            this->erase(cursor_.y, begin, end);
+        } break;
+        case 'X': this->erase(cursor_.y, cursor_.x, cursor_.x + n); break;
+        case 'b':
+            for (auto i = 0; i < n; ++i)
+                this->put(last_symbol_);
+            return;  // put() sets wrap_pending_.
+        default: return;  // Not supported, no effect on the screen.
+    }
+    wrap_pending_ = false;
+}
+
+void Headless_backend::apply_sgr(std::vector<int> const& parameters)
+{
+    using Kind = Sgr_color::Kind;
+    if (parameters.empty()) {
+        pen_ = Cell{};
+        return;
+    }
+    for (auto i = std::size_t{0}; i < parameters.size(); ++i) {
+        auto const code = parameters[i];
+        if (code == 0)
+            pen_ = Cell{};
+        else if (code >= 1 && code <= 9)
+            pen_.attributes |= (1u << code);
+        else if (code == 22)
+            pen_.attributes &= ~((1u << 1) | (1u << 2));
+        else if (code >= 23 && code <= 29)
+            pen_.attributes &= ~(1u << (code - 20));
+        else if (code >= 30 && code <= 37)
+            pen_.foreground = {Kind::Index, std::uint32_t(code - 30)};
+        else if (code >= 40 && code <= 47)
+            pen_.background = {Kind::Index, std::uint32_t(code - 40)};
+        else if (code >= 90 && code <= 97)
+            pen_.foreground = {Kind::Index, std::uint32_t(code - 90 + 8)};
+        else if (code >= 100 && code <= 107)
+            pen_.background = {Kind::Index, std::uint32_t(code - 100 + 8)};
+        else if (code == 39)
+            pen_.foreground = {};
+        else if (code == 49)
+            pen_.background = {};
+        else if (code == 38 || code == 48) {
+            auto& color = code == 38 ? pen_.foreground : pen_.background;
+            if (i + 2 < parameters.size() && parameters[i + 1] == 5) {
+                color = {Kind::Index, std::uint32_t(parameters[i + 2])};
+                i += 2;
+            }
+            else if (i + 4 < parameters.size() && parameters[i + 1] == 2) {
+                color = {Kind::RGB, std::uint32_t((parameters[i + 2] << 16) |
+                                                  (parameters[i + 3] << 8) |
+                                                  parameters[i + 4])};
+                i += 4;
+            }
+        }
+    }
+}
+
+void Headless_backend::put(char32_t symbol)
+{
+    if (wrap_pending_) {
+        cursor_.x = 0;
+        this->line_feed();
+        wrap_pending_ = false;
+    }
+    last_symbol_     = symbol;
+    auto const width = cell_width(symbol);
+    auto& c          = this->cell(cursor_);
+    c                = pen_;
+    c.symbol         = symbol;
+    if (width == 2 && cursor_.x + 1 < area_.width) {
+        auto& next  = this->cell({cursor_.x + 1, cursor_.y});
+        next        = pen_;
+        next.symbol = U'\0';
+    }
+    // Writing to the last column leaves the cursor there, pending a wrap.
+    if (cursor_.x + width < area_.width)
+        cursor_.x += width;
+    else
+        wrap_pending_ = true;
+}
+
+void Headless_backend::line_feed()
+{
+    if (cursor_.y == scroll_bottom_ - 1)
+        this->scroll(1);
+    else if (cursor_.y + 1 < area_.height)
+        ++cursor_.y;
+}
+
+void Headless_backend::reverse_index()
+{
+    if (cursor_.y == scroll_top_)
+        this->scroll(-1);
+    else if (cursor_.y > 0)
+        --cursor_.y;
+}
+
+void Headless_backend::scroll(int n)
+{
+    auto const height = scroll_bottom_ - scroll_top_;
+    n                 = std::clamp(n, -height, height);
+    auto const row    = [this](int y) {
+        return std::next(std::begin(screen_), y * area_.width);
+    };
+    if (n > 0)
+        std::move(row(scroll_top_ + n), row(scroll_bottom_), row(scroll_top_));
+    else {
+        std::move_backward(row(scroll_top_), row(scroll_bottom_ + n),
+                           row(scroll_bottom_));
+    }
+    auto const [first, last] =
+        n > 0 ? std::pair{scroll_bottom_ - n, scroll_bottom_}
+              : std::pair{scroll_top_, scroll_top_ - n};
+    for (auto y = first; y < last; ++y)
+        this->erase(y, 0, area_.width);
+}
+
+void Headless_backend::erase(int y, int begin, int end)
+{
+    auto blank       = Cell{};
+    blank.background = pen_.background;
+    for (auto x = std::max(begin, 0); x < std::min(end, area_.width); ++x)
+        this->cell({x, y}) = blank;
+}
+
+}  // namespace ox
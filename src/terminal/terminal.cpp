@@ -2,17 +2,17 @@
 
 #include <cassert>
 #include <csignal>
+#include <cstddef>
 #include <cstdlib>
 #include <iterator>
-#include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <variant>
 
 #include <esc/esc.hpp>
 
-#include <caterm/common/u32_to_mb.hpp>
 #include <caterm/painter/color.hpp>
 #include <caterm/painter/detail/is_paintable.hpp>
 #include <caterm/painter/palette/dawn_bringer16.hpp>
@@ -20,6 +20,10 @@
 #include <caterm/system/event.hpp>
 #include <caterm/system/system.hpp>
 #include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/terminal/detail/color_sequence_table.hpp>
+#include <caterm/terminal/detail/frame_encoder.hpp>
+#include <caterm/terminal/detail/frame_writer.hpp>
+#include <caterm/terminal/frame_stats.hpp>
 #include <caterm/widget/widget.hpp>
 
 extern "C" void uninit_and_exit(int /* sig*/)
@@ -30,51 +34,46 @@ extern "C" void uninit_and_exit(int /* sig*/)
 
 namespace {
 
-using Color_store = std::map<ox::Color, std::string>;
-
-auto fg_store = Color_store{};
+/// Return the table of foreground Color escape sequences.
+/** Colors not in the currently set palette map to the terminal default
+ *  foreground color sequence. */
+[[nodiscard]] auto fg_table() -> ox::detail::Color_sequence_table&
+{
+    static auto table = ox::detail::Color_sequence_table{
+        esc::escape(foreground(esc::Default_color{}))};
+    return table;
+}
 
-auto bg_store = Color_store{};
+/// Return the table of background Color escape sequences.
+/** Colors not in the currently set palette map to the terminal default
+ *  background color sequence. */
+[[nodiscard]] auto bg_table() -> ox::detail::Color_sequence_table&
+{
+    static auto table = ox::detail::Color_sequence_table{
+        esc::escape(background(esc::Default_color{}))};
+    return table;
+}
 
 /// Return the terminal escape sequence for the given Color \p c as foreground.
-/** Returns the terminal default foreground color sequence if \p c is not in the
- *  currently set palette. */
-[[nodiscard]] auto get_fg_sequence(ox::Color c) -> std::string
+[[nodiscard]] auto get_fg_sequence(ox::Color c) -> std::string_view
 {
-    if (auto const iter = fg_store.find(c); iter != std::cend(fg_store))
-        return iter->second;
-    else
-        return esc::escape(foreground(esc::Default_color{}));
+    return fg_table().get(c);
 }
 
 /// Return the terminal escape sequence for the given Color \p c as background.
-/** Returns the terminal default background color sequence if \p c is not in the
- *  currently set palette. */
-[[nodiscard]] auto get_bg_sequence(ox::Color c) -> std::string
-{
-    if (auto const iter = bg_store.find(c); iter != std::cend(bg_store))
-        return iter->second;
-    else
-        return esc::escape(background(esc::Default_color{}));
-}
-
-/// Convert a Canvas::Diff into a terminal escape sequence.
-[[nodiscard]] auto to_escape_sequence(ox::detail::Canvas::Diff const& diff)
-    -> std::string
-{
-    auto sequence = std::string{};
-    for (auto [point, glyph] : diff) {
-        using esc::escape;
-        sequence.append(escape(esc::Cursor_position{point}));
-        if (::esc::traits() != glyph.brush.traits)
-            sequence.append(escape(glyph.brush.traits));
-        sequence.append(get_fg_sequence(glyph.brush.foreground));
-        sequence.append(get_bg_sequence(glyph.brush.background));
-        sequence.append(ox::u32_to_mb(glyph.symbol));
-    }
-    return sequence;
+[[nodiscard]] auto get_bg_sequence(ox::Color c) -> std::string_view
+{
+    return bg_table().get(c);
 }
 
+/// Keeps track of the terminal cursor and Brush between writes.
+auto frame_encoder =
+    ox::detail::Frame_encoder{&get_fg_sequence, &get_bg_sequence};
+
+auto constexpr hide_cursor_sequence = std::string_view{"\033[?25l"};
+
+auto constexpr show_cursor_sequence = std::string_view{"\033[?25h"};
+
 /// Used as the return type for color_sequences() functions.
 struct Color_sequences {
     std::string fg, bg;
@@ -186,11 +185,14 @@ void Terminal::initialize(Mouse_mode mouse_mode,
 {
     if (is_initialized_)
         return;
-    ::esc::initialize_interactive_terminal(mouse_mode, key_mode, signals);
+    backend_->initialize(mouse_mode, key_mode, signals);
     if (handle_sigint_)
         std::signal(SIGINT, &uninit_and_exit);
     Terminal::set_palette(dawn_bringer16::palette);
     screen_buffers.resize(Terminal::area());
+    frame_encoder.set_capabilities(backend_->capabilities());
+    frame_encoder.invalidate();
+    frame_writer_.start(*backend_);
     is_initialized_ = true;
 }
 
@@ -198,52 +200,50 @@ void Terminal::uninitialize()
 {
     if (!is_initialized_)
         return;
-    ::esc::uninitialize_terminal();
+    frame_writer_.stop();
+    backend_->uninitialize();
     is_initialized_ = false;
 }
 
-auto Terminal::area() -> Area { return ::esc::terminal_area(); }
+auto Terminal::area() -> Area { return backend_->area(); }
 
 void Terminal::refresh()
 {
-    if (full_repaint_) {
-        screen_buffers.merge();
-        esc::write(to_escape_sequence(screen_buffers.current_screen_as_diff()));
-        full_repaint_ = false;
-    }
-    else
-        esc::write(to_escape_sequence(screen_buffers.merge_and_diff()));
-    esc::flush();
-    screen_buffers.next.reset();
+    Terminal::encode_changes();
+    Terminal::write_frame();
 }
 
 void Terminal::update_color_stores(Color c, True_color tc)
 {
-    fg_store[c] = esc::escape(foreground(tc));
-    bg_store[c] = esc::escape(background(tc));
+    fg_table().set(c, esc::escape(foreground(tc)));
+    bg_table().set(c, esc::escape(background(tc)));
+    frame_encoder.invalidate_brush();
 }
 
 void Terminal::repaint_color(Color c)
 {
-    esc::write(to_escape_sequence(screen_buffers.generate_color_diff(c)));
-    esc::flush();
+    frame_encoder.encode(screen_buffers.generate_color_diff(c),
+                         screen_buffers.area(), frame_buffer_);
 }
 
 void Terminal::set_palette(Palette colors)
 {
     dynamic_color_engine_.clear();
     palette_ = std::move(colors);
+    fg_table().reset();
+    bg_table().reset();
     for (auto const& [color, color_type] : palette_) {
         auto [fg, bg] = std::visit(
             [&](auto const& x) { return color_sequences(x); }, color_type);
-        fg_store[color] = fg;
-        bg_store[color] = bg;
+        fg_table().set(color, fg);
+        bg_table().set(color, bg);
         if (std::holds_alternative<Dynamic_color>(color_type)) {
             dynamic_color_engine_.start();  // no-op if already running
             dynamic_color_engine_.register_color(
                 color, std::get<Dynamic_color>(color_type));
         }
     }
+    frame_encoder.invalidate_brush();
     Terminal::flag_full_repaint();
     palette_changed(palette_);
 }
@@ -266,43 +266,118 @@ auto Terminal::current_palette() -> Palette const& { return palette_; }
 
 void Terminal::show_cursor(bool show)
 {
-    ::esc::set(show ? ::esc::Cursor::Show : ::esc::Cursor::Hide);
-    ::esc::flush();
+    // Queued repaint_color() output must stay ahead of this, and is left
+    // queued for the next frame.
+    auto const is_queued = !frame_buffer_.empty();
+    frame_buffer_.append(show ? show_cursor_sequence : hide_cursor_sequence);
+    if (!is_queued)
+        Terminal::write_frame();
 }
 
 void Terminal::move_cursor(Point point)
 {
-    ::esc::write(::esc::escape(::esc::Cursor_position{point}));
-    ::esc::flush();
+    // Queued repaint_color() output must stay ahead of this, and is left
+    // queued for the next frame.
+    auto const is_queued = !frame_buffer_.empty();
+    frame_encoder.move_cursor(point, frame_buffer_);
+    if (!is_queued)
+        Terminal::write_frame();
 }
 
 auto Terminal::color_count() -> std::uint16_t
 {
-    return ::esc::color_palette_size();
+    return backend_->color_palette_size();
 }
 
-auto Terminal::has_true_color() -> bool { return ::esc::has_true_color(); }
+auto Terminal::has_true_color() -> bool { return backend_->has_true_color(); }
 
-auto Terminal::read_input() -> Event
+auto Terminal::read_input() -> std::optional<Event>
 {
+    auto const input = backend_->read();
+    if (!input.has_value())
+        return std::nullopt;
     return std::visit([](auto const& event) { return transform(event); },
-                      ::esc::read());
+                      *input);
 }
 
+auto Terminal::read_ready_input() -> std::optional<Event>
+{
+    auto const input = backend_->read_ready();
+    if (!input.has_value())
+        return std::nullopt;
+    return std::visit([](auto const& event) { return transform(event); },
+                      *input);
+}
+
+auto Terminal::wait_for_input() -> bool { return backend_->wait_for_input(); }
+
+void Terminal::wake() { backend_->wake(); }
+
+void Terminal::set_backend(Terminal_backend& backend) { backend_ = &backend; }
+
+auto Terminal::backend() -> Terminal_backend& { return *backend_; }
+
 void Terminal::flag_full_repaint() { full_repaint_ = true; }
 
-void Terminal::flush_screen()
+auto Terminal::flush_screen() -> bool
 {
-    Terminal::show_cursor(false);
-    Terminal::refresh();
+    // The writer is still behind on the last frame, these changes are left
+    // staged and go out with the next frame instead.
+    if (frame_writer_.is_full()) {
+        frame_writer_.record_dropped();
+        return false;
+    }
+    // Placed before any repaint_color() output that is already queued.
+    frame_buffer_.insert(0, hide_cursor_sequence);
+    Terminal::encode_changes();
     // Cursor
     Widget const* const fw = System::focus_widget();
-    if (fw != nullptr && detail::is_paintable(*fw)) {
+    if (fw != nullptr && detail::is_paintable(*fw) && fw->cursor.is_enabled()) {
         assert(is_within(fw->cursor.position(), fw->area()));
-        System::set_cursor(fw->cursor, fw->top_left());
+        auto const offset = fw->top_left();
+        auto const cursor = fw->cursor.position();
+        frame_encoder.move_cursor({offset.x + cursor.x, offset.y + cursor.y},
+                                  frame_buffer_);
+        frame_buffer_.append(show_cursor_sequence);
     }
+    Terminal::write_frame();
+    return true;
+}
+
+void Terminal::wait_for_output() { frame_writer_.wait_until_ready(); }
+
+auto Terminal::last_frame_stats() -> Frame_stats
+{
+    return frame_writer_.last_stats();
 }
 
+auto Terminal::total_frame_stats() -> Frame_stats
+{
+    return frame_writer_.total_stats();
+}
+
+void Terminal::encode_changes()
+{
+    if (full_repaint_) {
+        screen_buffers.merge();
+        frame_encoder.encode(screen_buffers.current_screen_as_diff(),
+                             screen_buffers.area(), frame_buffer_);
+        full_repaint_ = false;
+    }
+    else {
+        // Scrolled content is moved on the terminal instead of resent.
+        if (auto const s = screen_buffers.find_scroll(); s.has_value()) {
+            frame_encoder.scroll(*s, frame_buffer_);
+            screen_buffers.apply_scroll(*s);
+        }
+        frame_encoder.encode(screen_buffers.merge_and_diff(),
+                             screen_buffers.area(), frame_buffer_);
+    }
+    screen_buffers.next.reset();
+}
+
+void Terminal::write_frame() { frame_writer_.submit(frame_buffer_); }
+
 void Terminal::stop_dynamic_color_engine() { dynamic_color_engine_.stop(); }
 
 void Terminal::handle_signint(bool const x) { handle_sigint_ = x; }
@@ -0,0 +1,160 @@
+#include <caterm/terminal/terminal_backend.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <esc/esc.hpp>
+
+#include <caterm/terminal/key_mode.hpp>
+#include <caterm/terminal/mouse_mode.hpp>
+#include <caterm/terminal/signals.hpp>
+#include <caterm/terminal/terminal_capabilities.hpp>
+#include <caterm/widget/area.hpp>
+
+namespace {
+
+/// Write all of \p bytes to \p fd, return the number of write() calls made.
+/** Retries on partial writes and interrupts. Gives up on any other error, the
+ *  terminal has gone away and the rest of the bytes are dropped. */
+[[nodiscard]] auto write_all(int fd, std::string_view bytes) -> std::size_t
+{
+    auto syscalls = std::size_t{0};
+    while (!bytes.empty()) {
+        auto const result = ::write(fd, bytes.data(), bytes.size());
+        ++syscalls;
+        if (result >= 0)
+            bytes.remove_prefix(static_cast<std::size_t>(result));
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            auto pfd = ::pollfd{fd, POLLOUT, 0};
+            ::poll(&pfd, 1, -1);
+        }
+        else if (errno != EINTR)
+            break;
+    }
+    return syscalls;
+}
+
+/// Set O_NONBLOCK and FD_CLOEXEC on \p fd.
+void make_nonblocking(int fd)
+{
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+/// Return true if \p term starts with any of \p prefixes.
+template <std::size_t N>
+[[nodiscard]] auto starts_with_any(std::string_view term,
+                                   std::string_view const (&prefixes)[N])
+    -> bool
+{
+    for (auto const prefix : prefixes) {
+        if (term.substr(0, prefix.size()) == prefix)
+            return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+namespace ox {
+
+void Tty_backend::initialize(Mouse_mode mouse_mode,
+                             Key_mode key_mode,
+                             Signals signals)
+{
+    ::esc::initialize_interactive_terminal(mouse_mode, key_mode, signals);
+    // Before the Frame_writer thread starts, its writes bypass esc's buffer.
+    ::esc::flush();
+    int fds[2];
+    if (::pipe(fds) == 0) {
+        make_nonblocking(fds[0]);
+        make_nonblocking(fds[1]);
+        wake_read_ = fds[0];
+        wake_write_.store(fds[1]);
+    }
+}
+
+void Tty_backend::uninitialize()
+{
+    ::esc::uninitialize_terminal();
+    ::esc::flush();
+    if (wake_read_ == -1)
+        return;
+    ::close(wake_write_.exchange(-1));
+    ::close(wake_read_);
+    wake_read_ = -1;
+}
+
+auto Tty_backend::area() const -> Area { return ::esc::terminal_area(); }
+
+auto Tty_backend::write(std::string_view bytes) -> std::size_t
+{
+    return write_all(STDOUT_FILENO, bytes);
+}
+
+auto Tty_backend::read() -> std::optional<::esc::Event>
+{
+    return ::esc::read();
+}
+
+auto Tty_backend::read_ready() -> std::optional<::esc::Event>
+{
+    return ::esc::read(0);
+}
+
+auto Tty_backend::wait_for_input() -> bool
+{
+    if (wake_read_ == -1)
+        return true;
+    ::pollfd fds[] = {{STDIN_FILENO, POLLIN, 0}, {wake_read_, POLLIN, 0}};
+    // Interrupted by a signal, such as SIGWINCH, which read() reports.
+    if (::poll(fds, 2, -1) < 0)
+        return true;
+    if (fds[1].revents != 0) {
+        char buffer[64];
+        while (::read(wake_read_, buffer, sizeof(buffer)) > 0) {}
+    }
+    return fds[0].revents != 0;
+}
+
+void Tty_backend::wake()
+{
+    auto const fd = wake_write_.load();
+    if (fd == -1)
+        return;
+    // Fails once the pipe is full, the waiting thread is woken up already.
+    [[maybe_unused]] auto const result = ::write(fd, "", 1);
+}
+
+auto Tty_backend::color_palette_size() const -> std::uint16_t
+{
+    return ::esc::color_palette_size();
+}
+
+auto Tty_backend::has_true_color() const -> bool
+{
+    return ::esc::has_true_color();
+}
+
+auto Tty_backend::capabilities() const -> Terminal_capabilities
+{
+    // Terminals whose terminfo entries list rep and bce. screen and tmux erase
+    // to the default background, and are left out.
+    static constexpr std::string_view with_rep[] = {"xterm", "alacritty",
+                                                    "foot"};
+    static constexpr std::string_view with_bce[] = {
+        "xterm", "alacritty", "foot", "linux", "rxvt"};
+    auto const* const env = std::getenv("TERM");
+    auto const term       = std::string_view{env == nullptr ? "" : env};
+    return {starts_with_any(term, with_rep), starts_with_any(term, with_bce)};
+}
+
+}  // namespace ox
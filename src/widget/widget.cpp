@@ -3,6 +3,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <utility>
@@ -10,6 +11,7 @@
 #include <signals_light/signal.hpp>
 
 #include <caterm/painter/brush.hpp>
+#include <caterm/painter/detail/paint_cache.hpp>
 #include <caterm/painter/glyph.hpp>
 #include <caterm/system/event.hpp>
 #include <caterm/system/system.hpp>
@@ -107,7 +109,12 @@ auto Widget::top_left() const -> Point { return top_left_position_; }
 
 auto Widget::area() const -> Area { return area_; }
 
-void Widget::update() { System::post_event(Paint_event{*this}); }
+void Widget::update()
+{
+    if (paint_cache_ != nullptr)
+        paint_cache_->invalidate();
+    System::post_event(Paint_event{*this});
+}
 
 auto Widget::is_layout_type() const -> bool { return false; }
 
@@ -162,6 +169,17 @@ void Widget::disable_animation()
 
 auto Widget::is_animated() const -> bool { return is_animated_; }
 
+void Widget::enable_paint_cache(bool enable)
+{
+    if (enable == this->has_paint_cache())
+        return;
+    paint_cache_ = enable ? std::make_unique<detail::Paint_cache>() : nullptr;
+}
+
+void Widget::disable_paint_cache() { this->enable_paint_cache(false); }
+
+auto Widget::has_paint_cache() const -> bool { return paint_cache_ != nullptr; }
+
 auto Widget::get_descendants() const -> std::vector<Widget*>
 {
     auto descendants = std::vector<Widget*>{};
@@ -217,7 +235,11 @@ auto Widget::child_polished_event(Widget&) -> bool
 
 auto Widget::move_event(Point, Point) -> bool
 {
-    this->update();
+    // The cached Glyphs are still good, only where they go has changed.
+    if (paint_cache_ != nullptr)
+        System::post_event(Paint_event{*this});
+    else
+        this->update();
     return true;
 }
 
@@ -312,6 +334,11 @@ void Widget::set_area(Area a) { area_ = a; }
 
 void Widget::set_parent(Widget* parent) { parent_ = parent; }
 
+auto Widget::paint_cache() -> detail::Paint_cache*
+{
+    return paint_cache_.get();
+}
+
 auto widget(std::string name,
             Focus_policy focus_policy,
             Size_policy width_policy,
@@ -212,9 +212,7 @@ auto Text_view::paint_event(Painter& p) -> bool
 {
     auto line_n = 0;
     auto paint  = [&p, &line_n, this](Line_info const& line) {
-        auto const sub_begin = std::begin(this->contents_) + line.start_index;
-        auto const sub_end   = sub_begin + line.length;
-        auto start           = 0;
+        auto start = 0;
         switch (alignment_) {
             case Align::Top:
             case Align::Left: start = 0; break;
@@ -224,7 +222,8 @@ auto Text_view::paint_event(Painter& p) -> bool
             case Align::Bottom:
             case Align::Right: start = this->area().width - line.length; break;
         }
-        p.put(Glyph_string(sub_begin, sub_end), {start, line_n++});
+        p.put(this->contents_.view(line.start_index, line.length),
+              {start, line_n++});
     };
     auto const begin = std::next(std::cbegin(display_state_), this->top_line());
     auto const end   = [&] {
@@ -0,0 +1,43 @@
+#include <cstddef>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/system/animation_engine.hpp>
+#include <caterm/system/event.hpp>
+#include <caterm/widget/widget.hpp>
+
+TEST_CASE("Animation_engine: Re-register ten thousand Widgets",
+          "[Animation_engine]")
+{
+    using Engine_t          = ox::Animation_engine;
+    constexpr auto count    = std::size_t{10'000};
+    constexpr auto interval = Engine_t::Interval_t{500};
+
+    auto widgets = std::vector<ox::Widget>(count);
+    auto engine  = Engine_t{};
+    for (auto& w : widgets)
+        engine.register_widget(w, interval);
+    CHECK(engine.deadline_count() == count);
+
+    // Unregistering leaves stale deadlines, at most one per registered Widget.
+    auto is_bounded = true;
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        engine.unregister_widget(widgets[i]);
+        auto const registered = count - i - 1;
+        is_bounded = is_bounded && engine.deadline_count() <= 2 * registered;
+    }
+    CHECK(is_bounded);
+    CHECK(engine.is_empty());
+    CHECK(engine.deadline_count() == 0);
+    CHECK(!engine.earliest_deadline().has_value());
+
+    auto const start = Engine_t::Clock_t::now();
+    for (auto& w : widgets)
+        engine.register_widget(w, interval);
+    CHECK(engine.deadline_count() == count);
+    auto const earliest = engine.earliest_deadline();
+    REQUIRE(earliest.has_value());
+    CHECK(*earliest >= start + interval);
+    CHECK(*earliest <= Engine_t::Clock_t::now() + interval);
+}
@@ -0,0 +1,273 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string filter = ".";
+    double min_time    = 0.5;  // Seconds
+    bool json          = false;
+    std::string out;
+};
+
+struct Result {
+    std::string name;
+    long iterations;
+    double real_ns;  // Per iteration.
+    double cpu_ns;   // Per iteration.
+    double items_per_second;
+};
+
+/// Return the value of \p arg if it is --\p flag=value.
+auto flag_value(std::string_view arg, std::string_view flag)
+    -> std::optional<std::string>
+{
+    if (arg.substr(0, 2) != "--")
+        return std::nullopt;
+    arg.remove_prefix(2);
+    if (arg.substr(0, flag.size()) != flag ||
+        arg.substr(flag.size(), 1) != "=") {
+        return std::nullopt;
+    }
+    return std::string{arg.substr(flag.size() + 1)};
+}
+
+auto parse_options(int argc, char** argv) -> Options
+{
+    auto result = Options{};
+    for (auto i = 1; i < argc; ++i) {
+        auto const arg = std::string_view{argv[i]};
+        if (auto v = flag_value(arg, "benchmark_filter"))
+            result.filter = *v;
+        else if (auto v = flag_value(arg, "benchmark_min_time"))
+            result.min_time = std::stod(*v);
+        else if (auto v = flag_value(arg, "benchmark_format"))
+            result.json = *v == "json";
+        else if (auto v = flag_value(arg, "benchmark_out"))
+            result.out = *v;
+        else
+            std::cerr << "Unknown argument: " << arg << '\n';
+    }
+    return result;
+}
+
+auto run_name(bench::Benchmark const& b, std::vector<long> const& args)
+    -> std::string
+{
+    auto result = b.name;
+    for (auto a : args)
+        result += '/' + std::to_string(a);
+    return result;
+}
+
+/// Run with increasing iteration counts until it takes at least min_time.
+auto run_one(bench::Benchmark::Function_t fn,
+             std::vector<long> const& args,
+             double min_time) -> bench::State
+{
+    auto constexpr max_iterations = 1'000'000'000L;
+    auto iterations               = 1L;
+    while (true) {
+        auto state = bench::State{args, iterations};
+        fn(state);
+        auto const seconds =
+            std::chrono::duration<double>{state.real_time()}.count();
+        if (seconds >= min_time || iterations >= max_iterations)
+            return state;
+        // Aim 40% past min_time, growing by at most 10x each attempt.
+        auto const multiplier =
+            seconds <= 0. ? 10. : std::min(10., min_time * 1.4 / seconds);
+        iterations = std::max(static_cast<long>(iterations * multiplier),
+                              iterations + 1);
+        iterations = std::min(iterations, max_iterations);
+    }
+}
+
+auto escape_json(std::string_view s) -> std::string
+{
+    auto result = std::string{};
+    for (auto c : s) {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+void write_json(std::vector<Result> const& results,
+                char const* executable,
+                std::ostream& os)
+{
+    auto date           = std::string(32, '\0');
+    auto const now      = std::time(nullptr);
+    auto const date_end = std::strftime(date.data(), date.size(),
+                                        "%Y-%m-%dT%H:%M:%S%z",
+                                        std::localtime(&now));
+    date.resize(date_end);
+    os << "{\n  \"context\": {\n"
+       << "    \"date\": \"" << date << "\",\n"
+       << "    \"executable\": \"" << escape_json(executable) << "\",\n"
+       << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+       << "    \"library_build_type\": \"release\"\n"
+#else
+       << "    \"library_build_type\": \"debug\"\n"
+#endif
+       << "  },\n  \"benchmarks\": [";
+    auto first = true;
+    for (auto const& r : results) {
+        os << (first ? "\n" : ",\n") << "    {\n"
+           << "      \"name\": \"" << escape_json(r.name) << "\",\n"
+           << "      \"run_name\": \"" << escape_json(r.name) << "\",\n"
+           << "      \"run_type\": \"iteration\",\n"
+           << "      \"iterations\": " << r.iterations << ",\n"
+           << "      \"real_time\": " << r.real_ns << ",\n"
+           << "      \"cpu_time\": " << r.cpu_ns << ",\n"
+           << "      \"time_unit\": \"ns\"";
+        if (r.items_per_second > 0.)
+            os << ",\n      \"items_per_second\": " << r.items_per_second;
+        os << "\n    }";
+        first = false;
+    }
+    os << "\n  ]\n}\n";
+}
+
+void write_console_header(std::FILE* f)
+{
+    std::fprintf(f, "%-44s %14s %14s %12s %14s\n", "Benchmark", "Time",
+                 "CPU", "Iterations", "Items/s");
+    std::fprintf(f, "%s\n", std::string(102, '-').c_str());
+}
+
+void write_console(Result const& r, std::FILE* f)
+{
+    std::fprintf(f, "%-44s %11.0f ns %11.0f ns %12ld", r.name.c_str(),
+                 r.real_ns, r.cpu_ns, r.iterations);
+    if (r.items_per_second > 0.)
+        std::fprintf(f, " %14.4g", r.items_per_second);
+    std::fprintf(f, "\n");
+}
+
+}  // namespace
+
+namespace bench {
+
+State::State(std::vector<long> args, long iterations)
+    : args_{std::move(args)}, iterations_{iterations}, remaining_{iterations}
+{}
+
+auto State::keep_running() -> bool
+{
+    if (remaining_ == iterations_ && !is_timing_)
+        this->resume_timing();
+    if (remaining_ > 0) {
+        --remaining_;
+        return true;
+    }
+    this->pause_timing();
+    return false;
+}
+
+void State::pause_timing()
+{
+    if (!is_timing_)
+        return;
+    cpu_time_ += std::chrono::nanoseconds{static_cast<long long>(
+        (std::clock() - cpu_start_) * (1e9 / CLOCKS_PER_SEC))};
+    real_time_ += Clock_t::now() - real_start_;
+    is_timing_ = false;
+}
+
+void State::resume_timing()
+{
+    if (is_timing_)
+        return;
+    is_timing_  = true;
+    cpu_start_  = std::clock();
+    real_start_ = Clock_t::now();
+}
+
+auto State::range(std::size_t i) const -> long { return args_.at(i); }
+
+void State::set_items_processed(long count) { items_ = count; }
+
+auto State::iterations() const -> long { return iterations_; }
+
+auto State::real_time() const -> std::chrono::nanoseconds { return real_time_; }
+
+auto State::cpu_time() const -> std::chrono::nanoseconds { return cpu_time_; }
+
+auto State::items_processed() const -> long { return items_; }
+
+Benchmark::Benchmark(std::string name_, Function_t fn)
+    : name{std::move(name_)}, function{fn}
+{}
+
+auto Benchmark::args(std::vector<long> args) -> Benchmark&
+{
+    arg_lists.push_back(std::move(args));
+    return *this;
+}
+
+auto Benchmark::range(long first, long last, long multiplier) -> Benchmark&
+{
+    for (auto i = first; i < last; i *= multiplier)
+        this->args({i});
+    return this->args({last});
+}
+
+auto run(std::vector<Benchmark> const& benchmarks, int argc, char** argv)
+    -> int
+{
+    auto const options = parse_options(argc, argv);
+    auto const filter  = std::regex{options.filter};
+    auto results       = std::vector<Result>{};
+    if (!options.json)
+        write_console_header(stdout);
+    for (auto const& b : benchmarks) {
+        for (auto const& args : b.arg_lists) {
+            auto const name = run_name(b, args);
+            if (!std::regex_search(name, filter))
+                continue;
+            auto const state = run_one(b.function, args, options.min_time);
+            auto const n     = static_cast<double>(state.iterations());
+            auto const real  = static_cast<double>(state.real_time().count());
+            auto const cpu   = static_cast<double>(state.cpu_time().count());
+            auto const items =
+                state.items_processed() > 0 && real > 0.
+                    ? static_cast<double>(state.items_processed()) * 1e9 / real
+                    : 0.;
+            results.push_back({name, state.iterations(), real / n, cpu / n,
+                               items});
+            if (!options.json)
+                write_console(results.back(), stdout);
+        }
+    }
+    if (options.json)
+        write_json(results, argv[0], std::cout);
+    if (!options.out.empty()) {
+        auto file = std::ofstream{options.out};
+        write_json(results, argv[0], file);
+        if (!file) {
+            std::cerr << "Could not write to " << options.out << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
+
+}  // namespace bench
@@ -0,0 +1,101 @@
+#ifndef CATERM_TESTS_BENCH_HPP
+#define CATERM_TESTS_BENCH_HPP
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// Minimal benchmark harness, command line flags and JSON output follow Google
+// Benchmark, so its tools/compare.py can compare two runs.
+
+namespace bench {
+
+/// Passed to each benchmark function, controls the timed loop.
+/** The function does its setup, then loops on keep_running(), only the time
+ *  spent in the loop, outside of pause_timing()/resume_timing(), counts. */
+class State {
+   public:
+    State(std::vector<long> args, long iterations);
+
+   public:
+    /// Return true until the requested number of iterations have been run.
+    [[nodiscard]] auto keep_running() -> bool;
+
+    /// Stop the timer, for per iteration setup that should not be measured.
+    void pause_timing();
+
+    /// Restart the timer after pause_timing().
+    void resume_timing();
+
+    /// Return argument \p i of this run.
+    [[nodiscard]] auto range(std::size_t i = 0) const -> long;
+
+    /// Set the total number of items processed, reported as items per second.
+    void set_items_processed(long count);
+
+   public:
+    [[nodiscard]] auto iterations() const -> long;
+
+    [[nodiscard]] auto real_time() const -> std::chrono::nanoseconds;
+
+    [[nodiscard]] auto cpu_time() const -> std::chrono::nanoseconds;
+
+    [[nodiscard]] auto items_processed() const -> long;
+
+   private:
+    using Clock_t = std::chrono::steady_clock;
+
+    std::vector<long> args_;
+    long iterations_;
+    long remaining_;
+    long items_ = 0;
+
+    Clock_t::time_point real_start_;
+    std::clock_t cpu_start_ = 0;
+    std::chrono::nanoseconds real_time_{0};
+    std::chrono::nanoseconds cpu_time_{0};
+    bool is_timing_ = false;
+};
+
+/// A named benchmark function and the argument lists it is run with.
+class Benchmark {
+   public:
+    using Function_t = void (*)(State&);
+
+   public:
+    Benchmark(std::string name, Function_t fn);
+
+   public:
+    /// Add a run with \p args, reported as name/arg0/arg1/...
+    auto args(std::vector<long> args) -> Benchmark&;
+
+    /// Add a single argument run for each power of \p multiplier in range.
+    /** \p first and \p last are always included. */
+    auto range(long first, long last, long multiplier = 8) -> Benchmark&;
+
+   public:
+    std::string name;
+    Function_t function;
+    std::vector<std::vector<long>> arg_lists;
+};
+
+/// Run each of \p benchmarks that match the command line filter.
+/** Flags: --benchmark_filter=<regex>, --benchmark_min_time=<seconds>,
+ *  --benchmark_format=<console|json> and --benchmark_out=<file>, which writes
+ *  JSON. Returns the exit code for main. */
+auto run(std::vector<Benchmark> const& benchmarks, int argc, char** argv)
+    -> int;
+
+/// Prevent the compiler from optimizing away the computation of \p value.
+template <typename T>
+void do_not_optimize(T const& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Force all pending memory writes to be made.
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+}  // namespace bench
+#endif  // CATERM_TESTS_BENCH_HPP
@@ -0,0 +1,123 @@
+#include <string>
+#include <vector>
+
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/terminal/detail/glyph_search.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+#include "bench.hpp"
+
+// Compares the Canvas merge and diff kernels on full screen redraws. The
+// kernel is part of the benchmark name, ie: merge_and_diff/SSE2/480/135/1 is a
+// 480x135 Canvas with 1% of cells changed, diffed with the SSE2 kernel.
+
+namespace {
+
+using ox::detail::Canvas;
+using ox::detail::Glyph_search_isa;
+
+auto area_arg(bench::State const& state) -> ox::Area
+{
+    return {static_cast<int>(state.range(0)), static_cast<int>(state.range(1))};
+}
+
+/// Write to every cell of \p c, each \p percent_changed out of 100 get Blue.
+void paint(Canvas& c, long percent_changed)
+{
+    auto const a = c.area();
+    auto i       = 0;
+    for (auto y = 0; y < a.height; ++y) {
+        for (auto x = 0; x < a.width; ++x, ++i) {
+            auto const is_changed = (i % 100) < percent_changed;
+            auto const color =
+                is_changed ? ox::Color::Blue : ox::Color::Background;
+            c.at({x, y}) = ox::Glyph{U'x', bg(color)};
+        }
+    }
+}
+
+auto name(Glyph_search_isa isa) -> char const*
+{
+    switch (isa) {
+        case Glyph_search_isa::Scalar: return "Scalar";
+        case Glyph_search_isa::SSE2: return "SSE2";
+        case Glyph_search_isa::AVX2: return "AVX2";
+    }
+    return "";
+}
+
+/// Args: width, height, percent of cells changed.
+template <Glyph_search_isa isa>
+void merge_and_diff(bench::State& state)
+{
+    ox::detail::set_glyph_search_isa(isa);
+    auto const a = area_arg(state);
+    auto next    = Canvas{a};
+    auto current = Canvas{a};
+    auto restore = Canvas{a};
+    auto diff    = Canvas::Diff{};
+    paint(next, state.range(2));
+    paint(current, 0);
+    paint(restore, 0);
+    while (state.keep_running()) {
+        merge_and_diff(next, current, diff);
+        bench::do_not_optimize(diff.data());
+        state.pause_timing();
+        merge(restore, current);
+        state.resume_timing();
+    }
+    state.set_items_processed(state.iterations() * a.width * a.height);
+}
+
+/// Args: width, height; the Color diff of a screen with 1% of cells in Blue.
+template <Glyph_search_isa isa>
+void color_diff(bench::State& state)
+{
+    ox::detail::set_glyph_search_isa(isa);
+    auto const a = area_arg(state);
+    auto next    = Canvas{a};
+    auto current = Canvas{a};
+    auto diff    = Canvas::Diff{};
+    paint(next, 1);
+    merge(next, current);
+    while (state.keep_running()) {
+        generate_color_diff(ox::Color::Blue, current, diff);
+        bench::do_not_optimize(diff.data());
+    }
+    state.set_items_processed(state.iterations() * a.width * a.height);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    // 4K displays with an 8x16 and a 4x8 font.
+    auto const screens = std::vector<ox::Area>{{480, 135}, {960, 270}};
+
+    using Function_t = bench::Benchmark::Function_t;
+    auto benchmarks  = std::vector<bench::Benchmark>{};
+    auto const add   = [&](Glyph_search_isa isa, Function_t md, Function_t cd) {
+        // Kernels this CPU does not support are left out.
+        if (!ox::detail::set_glyph_search_isa(isa))
+            return;
+        auto const suffix = std::string{"/"} + name(isa);
+        auto merge        = bench::Benchmark{"merge_and_diff" + suffix, md};
+        auto color        = bench::Benchmark{"color_diff" + suffix, cd};
+        for (auto const [width, height] : screens) {
+            merge.args({width, height, 0}).args({width, height, 1});
+            color.args({width, height});
+        }
+        benchmarks.push_back(std::move(merge));
+        benchmarks.push_back(std::move(color));
+    };
+    add(Glyph_search_isa::Scalar, merge_and_diff<Glyph_search_isa::Scalar>,
+        color_diff<Glyph_search_isa::Scalar>);
+    add(Glyph_search_isa::SSE2, merge_and_diff<Glyph_search_isa::SSE2>,
+        color_diff<Glyph_search_isa::SSE2>);
+    add(Glyph_search_isa::AVX2, merge_and_diff<Glyph_search_isa::AVX2>,
+        color_diff<Glyph_search_isa::AVX2>);
+    return bench::run(benchmarks, argc, argv);
+}
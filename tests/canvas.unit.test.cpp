@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <clocale>
+#include <type_traits>
+#include <utility>
 
 #include <catch2/catch.hpp>
 
@@ -9,6 +12,16 @@
 
 void init() { std::setlocale(LC_ALL, "en_US.UTF-8"); }
 
+template <typename T, typename = void>
+struct Has_mutable_begin : std::false_type {};
+
+template <typename T>
+struct Has_mutable_begin<T, std::void_t<decltype(std::declval<T&>().begin())>>
+    : std::true_type {};
+
+// Writes through an iterator would bypass the dirty spans.
+static_assert(!Has_mutable_begin<ox::detail::Canvas>::value);
+
 TEST_CASE("Canvas: Everything", "[Canvas]")
 {
     init();
@@ -78,3 +91,229 @@ TEST_CASE("Canvas: Everything", "[Canvas]")
     CHECK(diff.at(2).first == ox::Point{3, 16});
     CHECK(diff.at(2).second == ox::Glyph{U'x', bg(ox::Color::Blue)});
 }
+
+TEST_CASE("Canvas: Dirty spans", "[Canvas]")
+{
+    auto next    = ox::detail::Canvas{{20, 10}};
+    auto current = ox::detail::Canvas{{20, 10}};
+
+    CHECK(next.dirty_span(3).begin >= next.dirty_span(3).end);
+
+    next.at({7, 3})  = ox::Glyph{U'a'};
+    next.at({2, 3})  = ox::Glyph{U'b'};
+    next.at({19, 9}) = ox::Glyph{U'c'};
+
+    CHECK(next.dirty_span(3).begin == 2);
+    CHECK(next.dirty_span(3).end == 8);
+    CHECK(next.dirty_span(9).begin == 19);
+    CHECK(next.dirty_span(9).end == 20);
+    CHECK(next.dirty_span(0).begin >= next.dirty_span(0).end);
+
+    auto diff = ox::detail::Canvas::Diff{};
+    merge_and_diff(next, current, diff);
+    REQUIRE(diff.size() == 3);
+    CHECK(diff.at(0).first == ox::Point{2, 3});
+    CHECK(diff.at(1).first == ox::Point{7, 3});
+    CHECK(diff.at(2).first == ox::Point{19, 9});
+    CHECK(*std::cbegin(current) == ox::Glyph{});
+
+    next.resize({10, 10});
+    CHECK(next.dirty_span(3).begin == 2);
+    CHECK(next.dirty_span(3).end == 8);
+    CHECK(next.dirty_span(9).begin >= next.dirty_span(9).end);
+
+    next.reset();
+    for (auto y = 0; y < 10; ++y)
+        CHECK(next.dirty_span(y).begin >= next.dirty_span(y).end);
+    CHECK(std::as_const(next).at({2, 3}) == ox::Glyph{});
+    CHECK(std::as_const(next).at({7, 3}) == ox::Glyph{});
+
+    // A run written at once is tracked the same as each of its cells.
+    std::fill_n(next.at({4, 5}, 3), 3, ox::Glyph{U'e'});
+    CHECK(next.dirty_span(5).begin == 4);
+    CHECK(next.dirty_span(5).end == 7);
+    CHECK(next.dirty_row_count() == 1);
+    CHECK(std::as_const(next).at({6, 5}) == ox::Glyph{U'e'});
+}
+
+TEST_CASE("Canvas: Color rows across frames", "[Canvas]")
+{
+    auto next    = ox::detail::Canvas{{10, 5}};
+    auto current = ox::detail::Canvas{{10, 5}};
+    auto diff    = ox::detail::Canvas::Diff{};
+
+    next.at({3, 2}) = ox::Glyph{U'x', bg(ox::Color::Red)};
+    next.at({6, 4}) = ox::Glyph{U'y', bg(ox::Color::Green)};
+    merge(next, current);
+    next.reset();
+
+    // The merged cells stay on screen, and indexed, after next is reset.
+    generate_color_diff(ox::Color::Red, current, diff);
+    REQUIRE(diff.size() == 1);
+    CHECK(diff.at(0).first == ox::Point{3, 2});
+    generate_color_diff(ox::Color::Green, current, diff);
+    REQUIRE(diff.size() == 1);
+    CHECK(diff.at(0).first == ox::Point{6, 4});
+
+    // A repaint in a new Color re-indexes the row.
+    next.at({3, 2}) = ox::Glyph{U'x', bg(ox::Color::Blue)};
+    merge(next, current);
+    next.reset();
+    generate_color_diff(ox::Color::Red, current, diff);
+    CHECK(diff.empty());
+    generate_color_diff(ox::Color::Blue, current, diff);
+    CHECK(diff.size() == 1);
+}
+
+TEST_CASE("Canvas: Scroll detection", "[Canvas]")
+{
+    auto const area = ox::Area{6, 8};
+    auto next       = ox::detail::Canvas{area};
+    auto current    = ox::detail::Canvas{area};
+    auto search     = ox::detail::Scroll_search{};
+
+    // Writes every row of a log, starting from line number \p first.
+    auto const write_log = [&](ox::detail::Canvas& c, int first) {
+        for (auto y = 0; y < area.height; ++y) {
+            for (auto x = 0; x < area.width; ++x) {
+                auto const line = static_cast<char32_t>(U'a' + first + y);
+                c.at({x, y})    = ox::Glyph{x == 0 ? line : U'.'};
+            }
+        }
+    };
+    write_log(next, 0);
+    merge(next, current);
+    next.reset();
+
+    write_log(next, 2);
+    auto const up = find_scroll(next, current, search);
+    REQUIRE(up.has_value());
+    CHECK(up->top == 0);
+    CHECK(up->bottom == 8);
+    CHECK(up->distance == 2);
+
+    // Only the two rows scrolled into view are left to write.
+    apply_scroll(*up, next, current);
+    auto diff = ox::detail::Canvas::Diff{};
+    merge_and_diff(next, current, diff);
+    REQUIRE(diff.size() == 12);
+    CHECK(diff.front().first == ox::Point{0, 6});
+    CHECK(diff.front().second == ox::Glyph{U'i'});
+    CHECK(diff.back().first == ox::Point{5, 7});
+    next.reset();
+
+    // The buffers grown by the first search are reused.
+    auto const* const sorted = search.sorted.data();
+    write_log(next, 1);
+    auto const down = find_scroll(next, current, search);
+    REQUIRE(down.has_value());
+    CHECK(down->top == 0);
+    CHECK(down->bottom == 8);
+    CHECK(down->distance == -1);
+    CHECK(search.sorted.data() == sorted);
+    next.reset();
+
+    // Rows that do not match any row of current are not a scroll.
+    for (auto y = 0; y < area.height; ++y)
+        next.at({1, y}) = ox::Glyph{U'#'};
+    CHECK(!find_scroll(next, current, search).has_value());
+}
+
+TEST_CASE("Canvas: Color rows", "[Canvas]")
+{
+    auto next    = ox::detail::Canvas{{10, 6}};
+    auto current = ox::detail::Canvas{{10, 6}};
+    auto diff    = ox::detail::Canvas::Diff{};
+
+    CHECK(current.color_rows().count(ox::Color::Background) == 6);
+    CHECK(current.color_rows().count(ox::Color::Red) == 0);
+    generate_color_diff(ox::Color::Red, current, diff);
+    CHECK(diff.empty());
+
+    next.at({2, 1}) = ox::Glyph{U'a', fg(ox::Color::Red)};
+    next.at({7, 4}) = ox::Glyph{U'b', bg(ox::Color::Red)};
+    next.at({0, 4}) = ox::Glyph{U'c', bg(ox::Color::Green)};
+    merge_and_diff(next, current, diff);
+    next.reset();
+    CHECK(current.dirty_row_count() == 0);
+    CHECK(current.color_rows().count(ox::Color::Red) == 2);
+    CHECK(current.color_rows().contains(1, ox::Color::Red));
+    CHECK(current.color_rows().contains(4, ox::Color::Red));
+    CHECK(!current.color_rows().contains(2, ox::Color::Red));
+
+    generate_color_diff(ox::Color::Red, current, diff);
+    REQUIRE(diff.size() == 2);
+    CHECK(diff.at(0).first == ox::Point{2, 1});
+    CHECK(diff.at(1).first == ox::Point{7, 4});
+
+    // Overwriting the only Red Glyph of a row removes the row from the index.
+    next.at({2, 1}) = ox::Glyph{U'a'};
+    merge(next, current);
+    next.reset();
+    CHECK(current.color_rows().count(ox::Color::Red) == 1);
+    CHECK(!current.color_rows().contains(1, ox::Color::Red));
+
+    // A row stays indexed until its last use of a Color is overwritten.
+    next.at({3, 3}) = ox::Glyph{U'd', bg(ox::Color::Blue)};
+    next.at({5, 3}) = ox::Glyph{U'e', fg(ox::Color::Blue)};
+    merge(next, current);
+    next.reset();
+    next.at({3, 3}) = ox::Glyph{U'd'};
+    merge(next, current);
+    next.reset();
+    CHECK(current.color_rows().contains(3, ox::Color::Blue));
+    next.at({5, 3}) = ox::Glyph{U'e'};
+    merge(next, current);
+    next.reset();
+    CHECK(current.color_rows().count(ox::Color::Blue) == 0);
+
+    // Scrolled rows move their Colors with them.
+    apply_scroll({0, 6, 2}, next, current);
+    next.reset();
+    CHECK(current.color_rows().contains(2, ox::Color::Red));
+    CHECK(current.color_rows().contains(2, ox::Color::Green));
+    CHECK(!current.color_rows().contains(4, ox::Color::Red));
+    generate_color_diff(ox::Color::Red, current, diff);
+    REQUIRE(diff.size() == 1);
+    CHECK(diff.at(0).first == ox::Point{7, 2});
+
+    current.resize({5, 6});
+    CHECK(current.color_rows().count(ox::Color::Red) == 0);
+    CHECK(current.color_rows().count(ox::Color::Green) == 1);
+}
+
+TEST_CASE("Canvas: Resize", "[Canvas]")
+{
+    auto c = ox::detail::Canvas{{4, 3}};
+    for (auto y = 0; y < 3; ++y) {
+        for (auto x = 0; x < 4; ++x)
+            c.at({x, y}) = ox::Glyph{static_cast<char32_t>(U'a' + y * 4 + x)};
+    }
+
+    // Read through a const reference, the non-const at() marks cells dirty.
+    auto const& view = c;
+    c.resize({2, 4});
+    CHECK(view.at({0, 0}) == ox::Glyph{U'a'});
+    CHECK(view.at({1, 0}) == ox::Glyph{U'b'});
+    CHECK(view.at({1, 2}) == ox::Glyph{U'j'});
+    CHECK(view.at({0, 3}) == ox::Glyph{});
+    CHECK(c.dirty_span(2).end == 2);
+    CHECK(c.dirty_span(3).begin >= c.dirty_span(3).end);
+
+    c.resize({5, 2});
+    CHECK(view.at({1, 1}) == ox::Glyph{U'f'});
+    CHECK(view.at({2, 1}) == ox::Glyph{});
+    CHECK(view.at({4, 0}) == ox::Glyph{});
+
+    // The two buffers are reused once they are large enough.
+    c.resize({40, 40});
+    c.resize({40, 40});
+    auto const* const first  = &*std::cbegin(c);
+    c.resize({30, 20});
+    auto const* const second = &*std::cbegin(c);
+    c.resize({40, 40});
+    CHECK(&*std::cbegin(c) == first);
+    c.resize({20, 30});
+    CHECK(&*std::cbegin(c) == second);
+    CHECK(view.at({1, 1}) == ox::Glyph{U'f'});
+}
@@ -0,0 +1,426 @@
+#include <clocale>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <esc/event.hpp>
+
+#include <caterm/common/fps.hpp>
+#include <caterm/common/unique_queue.hpp>
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/painter/glyph_matrix.hpp>
+#include <caterm/painter/glyph_string.hpp>
+#include <caterm/painter/painter.hpp>
+#include <caterm/system/event.hpp>
+#include <caterm/system/event_queue.hpp>
+#include <caterm/system/system.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/terminal/detail/color_sequence_table.hpp>
+#include <caterm/terminal/detail/frame_encoder.hpp>
+#include <caterm/terminal/terminal.hpp>
+#include <caterm/terminal/terminal_backend.hpp>
+#include <caterm/terminal/terminal_capabilities.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/layouts/horizontal.hpp>
+#include <caterm/widget/layouts/vertical.hpp>
+#include <caterm/widget/point.hpp>
+#include <caterm/widget/widget.hpp>
+#include <caterm/widget/widgets/text_view.hpp>
+
+#include "bench.hpp"
+
+// Render pipeline benchmarks, see docs/manual/benchmarks.md.
+// Arguments are in the benchmark name, ie: merge_and_diff/200/60/1 is a 200x60
+// Canvas with 1% of cells changed.
+
+namespace {
+
+using ox::detail::Canvas;
+
+/// Discards all output, so only CaTerm's own work is timed.
+class Null_backend : public ox::Terminal_backend {
+   public:
+    void initialize(ox::Mouse_mode, ox::Key_mode, ox::Signals) override {}
+
+    void uninitialize() override {}
+
+    [[nodiscard]] auto area() const -> ox::Area override { return {200, 60}; }
+
+    auto write(std::string_view) -> std::size_t override { return 1; }
+
+    [[nodiscard]] auto read() -> std::optional<::esc::Event> override
+    {
+        return std::nullopt;
+    }
+
+    [[nodiscard]] auto read_ready() -> std::optional<::esc::Event> override
+    {
+        return std::nullopt;
+    }
+
+    [[nodiscard]] auto color_palette_size() const -> std::uint16_t override
+    {
+        return 256;
+    }
+
+    [[nodiscard]] auto has_true_color() const -> bool override { return true; }
+
+    [[nodiscard]] auto capabilities() const
+        -> ox::Terminal_capabilities override
+    {
+        return {true, true};
+    }
+};
+
+auto area_arg(bench::State const& state) -> ox::Area
+{
+    return {static_cast<int>(state.range(0)), static_cast<int>(state.range(1))};
+}
+
+/// Write to every cell of \p c, \p percent_changed out of 100 get \p color.
+void paint(Canvas& c, long percent_changed, ox::Color color = ox::Color::Blue)
+{
+    auto const a = c.area();
+    auto i       = 0;
+    for (auto y = 0; y < a.height; ++y) {
+        for (auto x = 0; x < a.width; ++x, ++i) {
+            auto const is_changed = (i % 100) < percent_changed;
+            auto const bg_color   = is_changed ? color : ox::Color::Background;
+            c.at({x, y})          = ox::Glyph{U'x', bg(bg_color)};
+        }
+    }
+}
+
+/// Args: width, height, percent of cells changed.
+void merge_and_diff(bench::State& state)
+{
+    auto const a = area_arg(state);
+    auto next    = Canvas{a};
+    auto current = Canvas{a};
+    auto restore = Canvas{a};
+    auto diff    = Canvas::Diff{};
+    paint(next, state.range(2));
+    paint(current, 0);
+    paint(restore, 0);
+    while (state.keep_running()) {
+        merge_and_diff(next, current, diff);
+        bench::do_not_optimize(diff.data());
+        state.pause_timing();
+        merge(restore, current);
+        state.resume_timing();
+    }
+    state.set_items_processed(state.iterations() * a.width * a.height);
+}
+
+/// Args: width, height, percent of cells repainted each tick.
+/** A frame where an animated Widget repaints its cells in a new Color, merged
+ *  into the screen, then the Color diff sent when that Color is a Dynamic_color
+ *  and its value changes. The repainted cells alternate between two Colors, so
+ *  each tick re-indexes them in the screen's Color_rows. */
+void dynamic_color_tick(bench::State& state)
+{
+    auto const a = area_arg(state);
+    auto next    = Canvas{a};
+    auto current = Canvas{a};
+    auto diff    = Canvas::Diff{};
+    paint(current, 0);
+    auto is_red = true;
+    while (state.keep_running()) {
+        state.pause_timing();
+        next.reset();
+        paint(next, state.range(2), is_red ? ox::Color::Red : ox::Color::Green);
+        state.resume_timing();
+        merge_and_diff(next, current, diff);
+        generate_color_diff(ox::Color::Red, current, diff);
+        bench::do_not_optimize(diff.data());
+        is_red = !is_red;
+    }
+    state.set_items_processed(state.iterations() * a.width * a.height);
+}
+
+/// Args: width, height; resizes between the given Area and half of it.
+void canvas_resize(bench::State& state)
+{
+    auto const large = area_arg(state);
+    auto const small = ox::Area{large.width / 2, large.height / 2};
+    auto c           = Canvas{large};
+    paint(c, 0);
+    while (state.keep_running()) {
+        c.resize(small);
+        c.resize(large);
+        bench::clobber_memory();
+    }
+    state.set_items_processed(state.iterations() * 2);
+}
+
+/// Args: width, height; encodes a full screen diff with mixed Brushes.
+void frame_encode(bench::State& state)
+{
+    static auto fg_table = [] {
+        auto result = ox::detail::Color_sequence_table{"\033[39m"};
+        for (auto i = 0; i < 256; ++i) {
+            auto const c = ox::Color{static_cast<ox::Color::Value_t>(i)};
+            result.set(c, "\033[38;5;" + std::to_string(i) + "m");
+        }
+        return result;
+    }();
+    static auto bg_table = [] {
+        auto result = ox::detail::Color_sequence_table{"\033[49m"};
+        for (auto i = 0; i < 256; ++i) {
+            auto const c = ox::Color{static_cast<ox::Color::Value_t>(i)};
+            result.set(c, "\033[48;5;" + std::to_string(i) + "m");
+        }
+        return result;
+    }();
+
+    auto const a = area_arg(state);
+    auto c       = Canvas{a};
+    for (auto y = 0; y < a.height; ++y) {
+        for (auto x = 0; x < a.width; ++x) {
+            // Runs of eight cells share a Brush, as in typical widget output.
+            auto const color =
+                ox::Color{static_cast<ox::Color::Value_t>((x / 8 + y) % 16)};
+            c.at({x, y}) = (x % 5 == 0 ? U'─' : U'a') | bg(color) | fg(color);
+        }
+    }
+    auto diff = Canvas::Diff{};
+    generate_full_diff(c, diff);
+    auto encoder = ox::detail::Frame_encoder{
+        [](ox::Color c) { return fg_table.get(c); },
+        [](ox::Color c) { return bg_table.get(c); }};
+    auto out = std::string{};
+    while (state.keep_running()) {
+        encoder.invalidate();
+        out.clear();
+        encoder.encode(diff, a, out);
+        bench::do_not_optimize(out.data());
+    }
+    state.set_items_processed(state.iterations() * diff.size());
+}
+
+/// Args: width, height; a Painter::fill of the whole Widget.
+void painter_fill(bench::State& state)
+{
+    auto const a = area_arg(state);
+    auto w       = ox::Widget{};
+    ox::System::send_event(ox::Resize_event{w, a});
+    auto c = Canvas{a};
+    while (state.keep_running()) {
+        // The Painter constructor does a wallpaper fill as well.
+        auto p = ox::Painter{w, c};
+        p.fill(U'#' | fg(ox::Color::Blue), {0, 0}, a);
+        bench::clobber_memory();
+    }
+    state.set_items_processed(state.iterations() * a.width * a.height * 2);
+}
+
+/// Args: width, height; a Painter::put of a Glyph_string on every row.
+void painter_put(bench::State& state)
+{
+    auto const a = area_arg(state);
+    auto w       = ox::Widget{};
+    ox::System::send_event(ox::Resize_event{w, a});
+    auto c          = Canvas{a};
+    auto const text = ox::Glyph_string{std::u32string(a.width, U'x')} |
+                      fg(ox::Color::Red);
+    while (state.keep_running()) {
+        auto p = ox::Painter{w, c};
+        for (auto y = 0; y < a.height; ++y)
+            p.put(text, {0, y});
+        bench::clobber_memory();
+    }
+    state.set_items_processed(state.iterations() * a.width * a.height);
+}
+
+/// Args: width, height; a Painter::put of a Glyph_matrix over the Widget.
+void painter_put_matrix(bench::State& state)
+{
+    auto const a = area_arg(state);
+    auto w       = ox::Widget{};
+    ox::System::send_event(ox::Resize_event{w, a});
+    auto c      = Canvas{a};
+    auto matrix = ox::Glyph_matrix{a};
+    for (auto y = 0; y < a.height; ++y) {
+        for (auto x = 0; x < a.width; ++x)
+            matrix({x, y}) = U'x' | bg(ox::Color::Blue);
+    }
+    while (state.keep_running()) {
+        auto p = ox::Painter{w, c};
+        p.put(matrix.view(), {0, 0});
+        bench::clobber_memory();
+    }
+    state.set_items_processed(state.iterations() * a.width * a.height);
+}
+
+/// Args: bytes, 0 for ASCII or 1 for multi-byte UTF-8 text.
+void glyph_string_from_utf8(bench::State& state)
+{
+    auto const piece = state.range(1) == 0 ? std::string{"abcd"}
+                                           : std::string{"ab─é"};
+    auto text = std::string{};
+    while (static_cast<long>(text.size()) < state.range(0))
+        text += piece;
+    while (state.keep_running()) {
+        auto const gs = ox::Glyph_string{text};
+        bench::do_not_optimize(gs.data());
+    }
+    state.set_items_processed(state.iterations() * text.size());
+}
+
+/// Args: elements appended, from a pool of half as many unique values.
+void unique_queue_compress(bench::State& state)
+{
+    auto const count = state.range(0);
+    auto gen         = std::mt19937{7};
+    auto dist        = std::uniform_int_distribution<int>(0, count / 2);
+    auto values      = std::vector<int>(count);
+    for (auto& v : values)
+        v = dist(gen);
+    auto queue = ox::Unique_queue<int>{};
+    while (state.keep_running()) {
+        state.pause_timing();
+        queue.clear();
+        for (auto v : values)
+            queue.append(v);
+        state.resume_timing();
+        queue.compress();
+        bench::do_not_optimize(queue.size());
+    }
+    state.set_items_processed(state.iterations() * count);
+}
+
+/// Args: Paint_events appended, to a pool of half as many Widgets.
+void paint_queue_compress(bench::State& state)
+{
+    auto const count = state.range(0);
+    auto gen         = std::mt19937{7};
+    auto dist        = std::uniform_int_distribution<long>(0, count / 2);
+    auto widgets     = std::vector<ox::Widget>(count / 2 + 1);
+    auto order       = std::vector<long>(count);
+    for (auto& i : order)
+        i = dist(gen);
+    auto queue = ox::detail::Paint_queue{};
+    while (state.keep_running()) {
+        state.pause_timing();
+        queue.clear();
+        for (auto i : order)
+            queue.append(ox::Paint_event{widgets[i]});
+        state.resume_timing();
+        queue.compress();
+        bench::do_not_optimize(queue.size());
+    }
+    state.set_items_processed(state.iterations() * count);
+}
+
+/// Exposes Text_view::update_display().
+class Text_view_bench : public ox::Text_view {
+   public:
+    using Text_view::Text_view;
+    using Text_view::update_display;
+};
+
+/// Args: Glyphs of text, Widget width; 24 lines tall, with word wrapping.
+void text_view_update_display(bench::State& state)
+{
+    auto text = std::u32string{};
+    while (static_cast<long>(text.size()) < state.range(0))
+        text += U"lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+    text.resize(state.range(0));
+    auto view = Text_view_bench{ox::Glyph_string{text}};
+    ox::System::send_event(
+        ox::Resize_event{view, {static_cast<int>(state.range(1)), 24}});
+    while (state.keep_running()) {
+        view.update_display();
+        bench::clobber_memory();
+    }
+    state.set_items_processed(state.iterations() * text.size());
+}
+
+/// Args: number of children; resizes the layout and flushes the frame.
+/** Includes sending the resulting Move, Resize and Paint Events to children,
+ *  and encoding the frame, output is thrown away by the Null_backend. */
+template <template <typename> typename Layout_t>
+void layout(bench::State& state)
+{
+    auto head = Layout_t<ox::Widget>{};
+    for (auto i = 0; i < state.range(0); ++i)
+        head.make_child();
+    // Outlives the benchmark, System keeps a reference to it.
+    static auto queue = ox::Event_queue{};
+    ox::System::set_current_queue(queue);
+    ox::System::set_head(&head);
+    queue.send_all();
+    auto const a = ox::Terminal::area();
+    auto const b = ox::Area{a.width - 1, a.height - 1};
+    auto is_a    = true;
+    while (state.keep_running()) {
+        ox::System::send_event(ox::Resize_event{head, is_a ? b : a});
+        queue.send_all();
+        is_a = !is_a;
+    }
+    ox::System::set_head(nullptr);
+    state.set_items_processed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::setlocale(LC_ALL, "en_US.UTF-8");
+    auto backend = Null_backend{};
+    ox::Terminal::set_backend(backend);
+    ox::Terminal::initialize();
+    ox::Terminal::frame_scheduler.set_max_fps(ox::FPS{0});
+
+    auto const screens = std::vector<std::vector<long>>{
+        {80, 24}, {200, 60}, {480, 135}};
+    auto with_screens = [&](bench::Benchmark b) {
+        for (auto const& s : screens)
+            b.args(s);
+        return b;
+    };
+
+    auto benchmarks = std::vector<bench::Benchmark>{
+        bench::Benchmark{"merge_and_diff", merge_and_diff}
+            .args({80, 24, 0})
+            .args({200, 60, 0})
+            .args({200, 60, 1})
+            .args({200, 60, 100})
+            .args({480, 135, 1}),
+        bench::Benchmark{"dynamic_color_tick", dynamic_color_tick}
+            .args({80, 24, 10})
+            .args({200, 60, 1})
+            .args({200, 60, 10})
+            .args({480, 135, 10}),
+        with_screens({"canvas_resize", canvas_resize}),
+        with_screens({"frame_encode", frame_encode}),
+        with_screens({"painter_fill", painter_fill}),
+        with_screens({"painter_put", painter_put}),
+        with_screens({"painter_put_matrix", painter_put_matrix}),
+        bench::Benchmark{"glyph_string_from_utf8", glyph_string_from_utf8}
+            .args({64, 0})
+            .args({64, 1})
+            .args({4096, 0})
+            .args({4096, 1}),
+        bench::Benchmark{"unique_queue_compress", unique_queue_compress}
+            .range(8, 4096),
+        bench::Benchmark{"paint_queue_compress", paint_queue_compress}
+            .range(8, 4096),
+        bench::Benchmark{"text_view_update_display", text_view_update_display}
+            .args({1'000, 80})
+            .args({100'000, 80})
+            .args({100'000, 200}),
+        bench::Benchmark{"layout_vertical", layout<ox::layout::Vertical>}
+            .range(1, 512),
+        bench::Benchmark{"layout_horizontal", layout<ox::layout::Horizontal>}
+            .range(1, 512),
+    };
+    auto const result = bench::run(benchmarks, argc, argv);
+    ox::Terminal::uninitialize();
+    return result;
+}
@@ -0,0 +1,135 @@
+#include <caterm/common/deadline_queue.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace {
+
+using Queue_t    = ox::Deadline_queue<std::size_t>;
+using Time_point = Queue_t::Time_point;
+using ms         = std::chrono::milliseconds;
+
+}  // namespace
+
+TEST_CASE("Deadline_queue: Earliest deadline first", "[Deadline_queue]")
+{
+    auto const start = Time_point{};
+    auto q           = Queue_t{};
+    q.push(start + ms{30}, 3);
+    q.push(start + ms{10}, 1);
+    q.push(start + ms{20}, 2);
+    REQUIRE(q.size() == 3);
+
+    CHECK(q.time_until_next(start, ms{100}) == ms{10});
+    CHECK(q.time_until_next(start, ms{5}) == ms{5});
+    CHECK(q.time_until_next(start + ms{15}, ms{100}) == ms{0});
+
+    CHECK(q.pop().value == 1);
+    CHECK(q.pop().value == 2);
+    CHECK(q.pop().value == 3);
+    CHECK(q.is_empty());
+    CHECK(q.time_until_next(start, ms{100}) == ms{100});
+}
+
+TEST_CASE("Deadline_queue: erase_if keeps the heap order", "[Deadline_queue]")
+{
+    auto const start = Time_point{};
+    auto q           = Queue_t{};
+    for (auto i = std::size_t{0}; i < 100; ++i)
+        q.push(start + ms{static_cast<int>((i * 37) % 100)}, i);
+    q.erase_if([](std::size_t i) { return i % 3 != 0; });
+    REQUIRE(q.size() == 34);
+
+    auto previous = start;
+    while (!q.is_empty()) {
+        auto const [deadline, value] = q.pop();
+        CHECK(value % 3 == 0);
+        CHECK(deadline >= previous);
+        previous = deadline;
+    }
+}
+
+TEST_CASE("Deadline_queue: next_deadline does not drift", "[Deadline_queue]")
+{
+    auto const start = Time_point{};
+
+    // Woken late, the next deadline stays on the original schedule.
+    CHECK(ox::next_deadline(start + ms{10}, ms{10}, start + ms{13}) ==
+          start + ms{20});
+
+    // More than an interval behind, the missed ticks are dropped.
+    CHECK(ox::next_deadline(start + ms{10}, ms{10}, start + ms{35}) ==
+          start + ms{45});
+}
+
+TEST_CASE("Deadline_queue: Ten thousand timers", "[Deadline_queue]")
+{
+    constexpr auto timer_count = std::size_t{10'000};
+    constexpr auto step        = ms{7};  // Time between simulated wake ups.
+    constexpr auto half_time   = ms{1'000};
+
+    struct Timer {
+        ms interval;
+        std::uint64_t id;
+        bool registered;
+        int fired;
+    };
+
+    auto timers = std::vector<Timer>{};
+    auto q      = Queue_t{};
+    auto start  = Time_point{};
+    for (auto i = std::size_t{0}; i < timer_count; ++i) {
+        auto const interval = ms{1 + static_cast<int>(i % 50)};
+        timers.push_back({interval, 0, true, 0});
+        q.push(start + interval, i);
+    }
+
+    auto visited    = std::size_t{0};
+    auto const fire = [&](std::size_t const& i) -> std::optional<ms> {
+        ++visited;
+        if (!timers[i].registered)
+            return std::nullopt;
+        ++timers[i].fired;
+        return timers[i].interval;
+    };
+    auto const run_until = [&](Time_point end) {
+        for (auto now = start + step; now <= end; now += step)
+            q.fire_due(now, fire);
+        start = end;
+    };
+
+    run_until(start + half_time);
+    auto fired_before = std::vector<int>{};
+    for (auto i = std::size_t{0}; i < timer_count; ++i) {
+        fired_before.push_back(timers[i].fired);
+        if (i % 2 == 0)
+            timers[i].registered = false;
+    }
+    visited = 0;
+    run_until(start + half_time);
+
+    // Each unregistered timer is visited once more, then dropped.
+    CHECK(q.size() == timer_count / 2);
+
+    auto fires = std::size_t{0};
+    for (auto i = std::size_t{0}; i < timer_count; ++i) {
+        auto const& t = timers[i];
+        if (!t.registered) {
+            CHECK(t.fired == fired_before[i]);
+            continue;
+        }
+        fires += static_cast<std::size_t>(t.fired - fired_before[i]);
+        // Wake ups are late by less than an interval, so no tick is missed.
+        if (t.interval >= step) {
+            auto const expected = 2 * half_time / t.interval;
+            CHECK(t.fired >= expected - 1);
+            CHECK(t.fired <= expected);
+        }
+    }
+    CHECK(visited == fires + timer_count / 2);
+}
@@ -0,0 +1,44 @@
+#include <cstddef>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/painter/color.hpp>
+#include <caterm/system/event.hpp>
+#include <caterm/terminal/dynamic_color_engine.hpp>
+
+TEST_CASE("Dynamic_color_engine: Re-register ten thousand times",
+          "[Dynamic_color_engine]")
+{
+    using Engine_t             = ox::Dynamic_color_engine;
+    constexpr auto count       = 10'000;
+    constexpr auto color_count = std::size_t{16};
+    constexpr auto interval    = Engine_t::Interval_t{500};
+
+    auto const dynamic = ox::Dynamic_color{
+        interval, [] { return ox::True_color{ox::RGB{0, 0, 0}}; }};
+    auto const color = [](int i) {
+        return ox::Color{static_cast<ox::Color::Value_t>(i % color_count)};
+    };
+    auto engine = Engine_t{};
+
+    // Each replaced Color leaves a stale deadline, at most one per live Color.
+    auto is_bounded = true;
+    for (auto i = 0; i < count; ++i) {
+        engine.register_color(color(i), dynamic);
+        is_bounded = is_bounded && engine.deadline_count() <= 2 * color_count;
+    }
+    CHECK(is_bounded);
+
+    for (auto i = 0; i < (int)color_count; ++i)
+        engine.unregister_color(color(i));
+    CHECK(engine.is_empty());
+    CHECK(engine.deadline_count() == 0);
+
+    auto const start = Engine_t::Clock_t::now();
+    for (auto i = 0; i < (int)color_count; ++i)
+        engine.register_color(color(i), dynamic);
+    CHECK(engine.deadline_count() == color_count);
+    auto const earliest = engine.earliest_deadline();
+    REQUIRE(earliest.has_value());
+    CHECK(*earliest >= start + interval);
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch.hpp>
+
+#include <caterm/system/event.hpp>
+#include <caterm/system/event_queue.hpp>
+#include <caterm/system/mouse.hpp>
+#include <caterm/system/system.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+#include <caterm/widget/widget.hpp>
+
+namespace {
+
+struct Geometry_counter : ox::Widget {
+    int moves       = 0;
+    int resizes     = 0;
+    int mouse_moves = 0;
+    ox::Mouse last_mouse;
+
+    // The base class handlers would post a Paint_event to the System.
+    auto move_event(ox::Point, ox::Point) -> bool override
+    {
+        ++moves;
+        return true;
+    }
+
+    auto resize_event(ox::Area, ox::Area) -> bool override
+    {
+        ++resizes;
+        return true;
+    }
+
+    auto mouse_move_event(ox::Mouse const& m) -> bool override
+    {
+        ++mouse_moves;
+        last_mouse = m;
+        return Widget::mouse_move_event(m);
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Basic_queue: Coalesces geometry events", "[Event_queue]")
+{
+    auto const before = ox::System::geometry_stats();
+    auto a            = Geometry_counter{};
+    auto b            = Geometry_counter{};
+    auto queue        = ox::detail::Basic_queue{};
+
+    queue.append(ox::Resize_event{a, {5, 5}});
+    queue.append(ox::Move_event{a, {1, 1}});
+    queue.append(ox::Resize_event{b, {2, 2}});
+    queue.append(ox::Resize_event{a, {7, 3}});
+    queue.append(ox::Move_event{a, {2, 4}});
+    CHECK(queue.size() == 3);
+    queue.send_all();
+
+    CHECK(a.resizes == 1);
+    CHECK(a.moves == 1);
+    CHECK(a.area() == ox::Area{7, 3});
+    CHECK(a.top_left() == ox::Point{2, 4});
+    CHECK(b.resizes == 1);
+
+    // Once sent, a new event is queued rather than folded into the old one.
+    queue.append(ox::Resize_event{a, {1, 1}});
+    queue.send_all();
+    CHECK(a.resizes == 2);
+
+    auto const after = ox::System::geometry_stats();
+    CHECK(after.posted - before.posted == 6);
+    CHECK(after.sent - before.sent == 4);
+}
+
+TEST_CASE("Basic_queue: Coalesces consecutive mouse moves", "[Event_queue]")
+{
+    using Button = ox::Mouse::Button;
+    auto a       = Geometry_counter{};
+    auto b       = Geometry_counter{};
+    auto queue   = ox::detail::Basic_queue{};
+
+    for (auto x = 0; x < 10; ++x)
+        queue.append(ox::Mouse_move_event{a, {{x, 0}, Button::Left, {}}});
+    queue.append(ox::Mouse_move_event{a, {{3, 3}, Button::Right, {}}});
+    queue.append(ox::Mouse_move_event{b, {{0, 0}, Button::Left, {}}});
+    queue.append(ox::Mouse_move_event{a, {{4, 4}, Button::Left, {}}});
+    CHECK(queue.size() == 3);
+    queue.send_all();
+
+    CHECK(a.mouse_moves == 2);
+    CHECK(a.last_mouse.at == ox::Point{4, 4});
+    CHECK(b.mouse_moves == 1);
+}
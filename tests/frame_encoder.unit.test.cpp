@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <clocale>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/terminal/detail/color_sequence_table.hpp>
+#include <caterm/terminal/detail/frame_encoder.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace {
+
+void init() { std::setlocale(LC_ALL, "en_US.UTF-8"); }
+
+auto fg_sequence(ox::Color c) -> std::string
+{
+    return "\033[38;5;" + std::to_string(c.value) + "m";
+}
+
+auto bg_sequence(ox::Color c) -> std::string
+{
+    return "\033[48;5;" + std::to_string(c.value) + "m";
+}
+
+/// Return a table holding the result of \p sequence for every Color.
+auto make_table(std::string (*sequence)(ox::Color))
+    -> ox::detail::Color_sequence_table
+{
+    auto table = ox::detail::Color_sequence_table{""};
+    for (auto i = 0; i < 256; ++i) {
+        auto const c = ox::Color{static_cast<std::uint8_t>(i)};
+        table.set(c, sequence(c));
+    }
+    return table;
+}
+
+auto const fg_table = make_table(&fg_sequence);
+
+auto const bg_table = make_table(&bg_sequence);
+
+auto fg_view(ox::Color c) -> std::string_view { return fg_table.get(c); }
+
+auto bg_view(ox::Color c) -> std::string_view { return bg_table.get(c); }
+
+/// Return the number of bytes the stateless per-cell encoding would take.
+/** Every cell is written with a full cursor position, fg and bg sequence. */
+auto stateless_size(ox::detail::Canvas::Diff const& diff) -> std::size_t
+{
+    auto size = std::size_t{0};
+    for (auto const& [point, glyph] : diff) {
+        size += ("\033[" + std::to_string(point.y + 1) + ";" +
+                 std::to_string(point.x + 1) + "H")
+                    .size();
+        size += fg_sequence(glyph.brush.foreground).size();
+        size += bg_sequence(glyph.brush.background).size();
+        size += 1;  // ASCII only in these tests.
+    }
+    return size;
+}
+
+auto const screen = ox::Area{80, 24};
+
+/// Set every cell of \p canvas to \p g.
+void fill(ox::detail::Canvas& canvas, ox::Glyph g)
+{
+    auto const [width, height] = canvas.area();
+    for (auto y = 0; y < height; ++y)
+        std::fill_n(canvas.at({0, y}, width), width, g);
+}
+
+}  // namespace
+
+TEST_CASE("Frame_encoder: Row of text with a single Brush", "[Frame_encoder]")
+{
+    auto encoder = ox::detail::Frame_encoder{&fg_view, &bg_view};
+    auto diff    = ox::detail::Canvas::Diff{};
+    auto const text = std::string{"abcdefghij"};
+    for (auto i = 0; i < (int)text.size(); ++i)
+        diff.push_back({{5 + i, 3}, ox::Glyph{(char32_t)text[i]}});
+
+    auto out = std::string{};
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\033[4;6H" + fg_sequence(ox::Color::Foreground) +
+                     bg_sequence(ox::Color::Background) + text);
+    CHECK(out.size() < stateless_size(diff));
+}
+
+TEST_CASE("Frame_encoder: State is kept between frames", "[Frame_encoder]")
+{
+    auto encoder = ox::detail::Frame_encoder{&fg_view, &bg_view};
+    auto diff    = ox::detail::Canvas::Diff{};
+    auto out     = std::string{};
+
+    diff.push_back({{0, 0}, ox::Glyph{U'a', fg(ox::Color::Red)}});
+    encoder.encode(diff, screen, out);
+
+    // Directly to the right with the same Brush, only the symbol is needed.
+    diff.clear();
+    out.clear();
+    diff.push_back({{1, 0}, ox::Glyph{U'b', fg(ox::Color::Red)}});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "b");
+
+    // Relative move and a foreground change.
+    diff.clear();
+    out.clear();
+    diff.push_back({{12, 0}, ox::Glyph{U'c', fg(ox::Color::Blue)}});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\033[10C" + fg_sequence(ox::Color::Blue) + "c");
+
+    // Start of next line.
+    diff.clear();
+    out.clear();
+    diff.push_back({{0, 1}, ox::Glyph{U'd', fg(ox::Color::Blue)}});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\r\nd");
+
+    // Moved by someone else.
+    encoder.set_cursor({40, 20});
+    diff.clear();
+    out.clear();
+    diff.push_back({{40, 19}, ox::Glyph{U'e', fg(ox::Color::Blue)}});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\033[Ae");
+
+    // Color definitions changed.
+    encoder.invalidate_brush();
+    diff.clear();
+    out.clear();
+    diff.push_back({{41, 19}, ox::Glyph{U'f', fg(ox::Color::Blue)}});
+    encoder.encode(diff, screen, out);
+    CHECK(out == fg_sequence(ox::Color::Blue) +
+                     bg_sequence(ox::Color::Background) + "f");
+}
+
+TEST_CASE("Frame_encoder: Last column and wide symbols", "[Frame_encoder]")
+{
+    init();
+    auto encoder = ox::detail::Frame_encoder{&fg_view, &bg_view};
+    auto diff    = ox::detail::Canvas::Diff{};
+    auto out     = std::string{};
+
+    diff.push_back({{79, 5}, ox::Glyph{U'a'}});
+    diff.push_back({{0, 6}, ox::Glyph{U'b'}});
+    encoder.encode(diff, screen, out);
+    // Pending wrap after the last column, position is not assumed.
+    CHECK(out.substr(out.size() - 5) == "\033[7Hb");
+
+    diff.clear();
+    out.clear();
+    diff.push_back({{10, 10}, ox::Glyph{U'中'}});
+    diff.push_back({{12, 10}, ox::Glyph{U'x'}});
+    encoder.encode(diff, screen, out);
+    CHECK(out.substr(out.size() - 9) == "\033[11;13Hx");
+}
+
+TEST_CASE("Frame_encoder: Full screen is smaller than stateless encoding",
+          "[Frame_encoder]")
+{
+    auto encoder = ox::detail::Frame_encoder{&fg_view, &bg_view};
+    auto canvas  = ox::detail::Canvas{screen};
+    fill(canvas, ox::Glyph{U' ', bg(ox::Color::Blue)});
+    auto diff = ox::detail::Canvas::Diff{};
+    generate_full_diff(canvas, diff);
+
+    auto out = std::string{};
+    encoder.encode(diff, screen, out);
+    CHECK(out.size() * 10 < stateless_size(diff));
+}
+
+TEST_CASE("Frame_encoder: Runs use REP, ECH and EL", "[Frame_encoder]")
+{
+    auto encoder = ox::detail::Frame_encoder{&fg_view, &bg_view};
+    auto diff    = ox::detail::Canvas::Diff{};
+    auto out     = std::string{};
+
+    // Sets diff to count cells of g in row y, starting at x.
+    auto const set_run = [&](int x, int y, int count, ox::Glyph g) {
+        diff.clear();
+        out.clear();
+        for (auto i = 0; i < count; ++i)
+            diff.push_back({{x + i, y}, g});
+    };
+
+    // Not used unless the terminal supports them.
+    set_run(0, 0, 10, ox::Glyph{U'x'});
+    encoder.encode(diff, screen, out);
+    CHECK(out.substr(out.size() - 10) == "xxxxxxxxxx");
+
+    encoder.set_capabilities({true, true});
+    set_run(0, 1, 10, ox::Glyph{U'x'});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\r\nx\033[9b");
+
+    // Too short to be worth repeating.
+    set_run(0, 2, 3, ox::Glyph{U'x'});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\r\nxxx");
+
+    // Cheaper than ECH, which is followed by a cursor move past the run.
+    set_run(0, 3, 30, ox::Glyph{U' '});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\r\n \033[29b");
+
+    // ECH leaves the cursor at the start of the run.
+    encoder.set_capabilities({false, true});
+    set_run(0, 4, 30, ox::Glyph{U' ', bg(ox::Color::Blue)});
+    diff.push_back({{30, 4}, ox::Glyph{U'a', bg(ox::Color::Blue)}});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\r\n" + bg_sequence(ox::Color::Blue) + "\033[30X\033[30Ca");
+
+    // EL for a run that reaches the end of the row.
+    encoder.set_capabilities({true, true});
+    set_run(50, 5, 30, ox::Glyph{U' ', bg(ox::Color::Blue)});
+    encoder.encode(diff, screen, out);
+    CHECK(out == "\033[6;51H\033[K");
+
+    // A space with Traits is visible, it is repeated instead of erased.
+    set_run(50, 6, 30, ox::Glyph{U' ', ox::Trait::Underline});
+    encoder.encode(diff, screen, out);
+    CHECK(out.substr(out.size() - 6) == " \033[29b");
+
+    // Full screen wallpaper, one erase per row.
+    auto canvas = ox::detail::Canvas{screen};
+    fill(canvas, ox::Glyph{U' ', bg(ox::Color::Green)});
+    generate_full_diff(canvas, diff);
+    out.clear();
+    encoder.encode(diff, screen, out);
+    CHECK(out.size() < 10 * (std::size_t)screen.height);
+}
+
+TEST_CASE("Color_sequence_table: Lookup and fallback", "[Frame_encoder]")
+{
+    auto table = ox::detail::Color_sequence_table{"\033[39m"};
+    CHECK(table.get(ox::Color::Red) == "\033[39m");
+
+    table.set(ox::Color::Red, "\033[38;2;255;255;255m");
+    CHECK(table.get(ox::Color::Red) == "\033[38;2;255;255;255m");
+    CHECK(table.get(ox::Color::Blue) == "\033[39m");
+
+    CHECK_THROWS_AS(table.set(ox::Color::Red, std::string(32, 'x')),
+                    std::length_error);
+
+    table.reset();
+    CHECK(table.get(ox::Color::Red) == "\033[39m");
+}
@@ -0,0 +1,103 @@
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/terminal/detail/frame_writer.hpp>
+#include <caterm/terminal/headless_backend.hpp>
+#include <caterm/widget/area.hpp>
+
+namespace {
+
+/// Headless_backend whose write() blocks until release() is called.
+class Stalled_backend : public ox::Headless_backend {
+   public:
+    Stalled_backend() : ox::Headless_backend{ox::Area{10, 2}} {}
+
+   public:
+    auto write(std::string_view bytes) -> std::size_t override
+    {
+        auto lock = std::unique_lock{mtx_};
+        is_writing_ = true;
+        changed_.notify_all();
+        changed_.wait(lock, [this] { return is_released_; });
+        return this->Headless_backend::write(bytes);
+    }
+
+    /// Block until a write() call has started.
+    void wait_for_write()
+    {
+        auto lock = std::unique_lock{mtx_};
+        changed_.wait(lock, [this] { return is_writing_; });
+    }
+
+    /// Let every write() call through.
+    void release()
+    {
+        {
+            auto const lock = std::lock_guard{mtx_};
+            is_released_    = true;
+        }
+        changed_.notify_all();
+    }
+
+   private:
+    std::mutex mtx_;
+    std::condition_variable changed_;
+    bool is_writing_  = false;
+    bool is_released_ = false;
+};
+
+}  // namespace
+
+TEST_CASE("Frame_writer: Writes from its own thread", "[Frame_writer]")
+{
+    auto term   = Stalled_backend{};
+    auto writer = ox::detail::Frame_writer{};
+    writer.start(term);
+
+    auto frame = std::string{"one"};
+    writer.submit(frame);
+    CHECK(frame.empty());
+    term.wait_for_write();
+
+    // The writer is stuck on the first frame, the second waits behind it.
+    frame = "\r\ntwo";
+    writer.submit(frame);
+    CHECK(writer.is_full());
+
+    // Never waits, a full writer appends to the pending frame.
+    frame = "!";
+    writer.submit(frame);
+    writer.record_dropped();
+
+    term.release();
+    writer.wait_until_ready();
+    writer.stop();
+
+    CHECK(term.row(0) == U"one       ");
+    CHECK(term.row(1) == U"two!      ");
+    CHECK(!writer.is_full());
+    auto const total = writer.total_stats();
+    CHECK(total.frames == 2);
+    CHECK(total.bytes == 9);
+    CHECK(total.dropped == 1);
+    CHECK(writer.last_stats().bytes == 6);
+}
+
+TEST_CASE("Frame_writer: Writes in place when not started", "[Frame_writer]")
+{
+    auto term   = ox::Headless_backend{{10, 2}};
+    auto writer = ox::detail::Frame_writer{};
+    writer.start(term);
+    writer.stop();
+
+    auto frame = std::string{"abc"};
+    writer.submit(frame);
+    CHECK(frame.empty());
+    CHECK(term.row(0) == U"abc       ");
+    CHECK(writer.last_stats().syscalls == 1);
+}
@@ -0,0 +1,64 @@
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/painter/glyph.hpp>
+#include <caterm/painter/glyph_matrix.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace {
+
+/// Return a matrix with each cell holding a distinct letter, row by row.
+auto letters(ox::Area a) -> ox::Glyph_matrix
+{
+    auto m = ox::Glyph_matrix{a};
+    for (auto y = 0; y < a.height; ++y) {
+        for (auto x = 0; x < a.width; ++x) {
+            auto const letter = static_cast<char32_t>(U'a' + y * a.width + x);
+            m({x, y})         = ox::Glyph{letter};
+        }
+    }
+    return m;
+}
+
+}  // namespace
+
+TEST_CASE("Glyph_matrix: Resize keeps rows", "[Glyph_matrix]")
+{
+    auto m = letters({4, 3});
+    CHECK(m.row(1)[2] == ox::Glyph{U'g'});
+
+    m.resize({6, 4});
+    CHECK(m.width() == 6);
+    CHECK(m.height() == 4);
+    CHECK(m({3, 2}) == ox::Glyph{U'l'});
+    CHECK(m({4, 2}) == ox::Glyph{});
+    CHECK(m({0, 3}) == ox::Glyph{});
+
+    m.resize({2, 5});
+    CHECK(m({1, 1}) == ox::Glyph{U'f'});
+    CHECK(m({0, 2}) == ox::Glyph{U'i'});
+    CHECK(m({1, 4}) == ox::Glyph{});
+
+    CHECK_THROWS_AS(m.at({2, 0}), std::out_of_range);
+    m.clear();
+    CHECK(m.width() == 0);
+    CHECK(m.height() == 0);
+}
+
+TEST_CASE("Glyph_matrix: Views", "[Glyph_matrix]")
+{
+    auto const m = letters({4, 3});
+    auto const v = m.view({1, 1}, {2, 5});
+    CHECK(v.width() == 2);
+    CHECK(v.height() == 2);
+    CHECK(v.stride() == 4);
+    CHECK(v({0, 0}) == ox::Glyph{U'f'});
+    CHECK(v.row(1)[1] == ox::Glyph{U'k'});
+
+    auto const inner = v.view({1, 1}, {3, 3});
+    CHECK(inner.width() == 1);
+    CHECK(inner.height() == 1);
+    CHECK(inner({0, 0}) == ox::Glyph{U'k'});
+}
@@ -0,0 +1,85 @@
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/painter/trait.hpp>
+#include <caterm/terminal/detail/glyph_search.hpp>
+
+namespace {
+
+using ox::detail::Glyph_search_isa;
+
+auto const all_isas = {Glyph_search_isa::Scalar, Glyph_search_isa::SSE2,
+                       Glyph_search_isa::AVX2};
+
+/// Return \p count Glyphs with a few symbols and Colors, some of them null.
+auto random_glyphs(int count, std::mt19937& gen) -> std::vector<ox::Glyph>
+{
+    auto dist   = std::uniform_int_distribution<int>{0, 3};
+    auto result = std::vector<ox::Glyph>{};
+    for (auto i = 0; i < count; ++i) {
+        result.push_back(ox::Glyph{(char32_t)dist(gen),
+                                   bg(ox::Color((std::uint8_t)dist(gen))),
+                                   fg(ox::Color((std::uint8_t)dist(gen)))});
+    }
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("Glyph search: Kernels agree with each other", "[Glyph_search]")
+{
+    auto const original = ox::detail::glyph_search_isa();
+    auto gen            = std::mt19937{7};
+    for (auto count : {0, 1, 3, 4, 7, 8, 9, 17, 100}) {
+        for (auto trial = 0; trial < 50; ++trial) {
+            auto const next    = random_glyphs(count, gen);
+            auto const current = random_glyphs(count, gen);
+            auto const color   = ox::Color((std::uint8_t)(trial % 4));
+
+            REQUIRE(ox::detail::set_glyph_search_isa(Glyph_search_isa::Scalar));
+            auto const changed =
+                ox::detail::find_changed(next.data(), current.data(), count);
+            auto const colored =
+                ox::detail::find_color(next.data(), count, color);
+
+            for (auto isa : all_isas) {
+                if (!ox::detail::set_glyph_search_isa(isa))
+                    continue;
+                CHECK(ox::detail::find_changed(next.data(), current.data(),
+                                               count) == changed);
+                CHECK(ox::detail::find_color(next.data(), count, color) ==
+                      colored);
+            }
+        }
+    }
+    ox::detail::set_glyph_search_isa(original);
+}
+
+TEST_CASE("Glyph search: Null symbols and Brush changes", "[Glyph_search]")
+{
+    auto const original = ox::detail::glyph_search_isa();
+    for (auto isa : all_isas) {
+        if (!ox::detail::set_glyph_search_isa(isa))
+            continue;
+        auto next    = std::vector<ox::Glyph>(20, ox::Glyph{U'a'});
+        auto current = next;
+        CHECK(ox::detail::find_changed(next.data(), current.data(), 20) == 20);
+
+        next[13] = ox::Glyph{U'a', ox::Trait::Bold};
+        CHECK(ox::detail::find_changed(next.data(), current.data(), 20) == 13);
+
+        // Null symbols are never merged, even though they differ.
+        for (auto i = 0; i < 13; ++i)
+            next[i] = ox::Glyph{};
+        next[5] = ox::Glyph{U'\0', fg(ox::Color::Red)};
+        CHECK(ox::detail::find_changed(next.data(), current.data(), 20) == 13);
+
+        CHECK(ox::detail::find_color(next.data(), 20, ox::Color::Red) == 5);
+        CHECK(ox::detail::find_color(next.data(), 20, ox::Color::Blue) == 20);
+    }
+    ox::detail::set_glyph_search_isa(original);
+}
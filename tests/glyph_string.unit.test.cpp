@@ -5,6 +5,7 @@
 #include <caterm/painter/brush.hpp>
 #include <caterm/painter/color.hpp>
 #include <caterm/painter/glyph_string.hpp>
+#include <caterm/painter/glyph_view.hpp>
 #include <caterm/painter/trait.hpp>
 #include <caterm/widget/pipe.hpp>
 
@@ -277,3 +278,24 @@ TEST_CASE("Brush pipe Glyph_string construction", "[Glyph_string]")
             CHECK(g.brush == brush);
     }
 }
+
+TEST_CASE("Glyph_view", "[Glyph_string]")
+{
+    auto const gs = ox::Glyph_string{U"Hello, World"};
+
+    auto const all = ox::Glyph_view{gs};
+    CHECK(all.size() == gs.size());
+    CHECK(all.data() == gs.data());
+
+    auto const sub = gs.view(7, 5);
+    REQUIRE(sub.size() == 5);
+    CHECK(sub[0].symbol == U'W');
+    CHECK(sub.data() == gs.data() + 7);
+    CHECK(ox::Glyph_string{sub}.u32str() == U"World");
+
+    // Clipped to the viewed range.
+    CHECK(gs.view(10, 100).size() == 2);
+    CHECK(gs.view(100).empty());
+    CHECK(sub.subview(3).size() == 2);
+    CHECK(sub.subview(-2, 1)[0].symbol == U'W');
+}
@@ -0,0 +1,351 @@
+#include <array>
+#include <clocale>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/painter/color.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/system/key.hpp>
+#include <caterm/system/system.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/terminal/detail/frame_encoder.hpp>
+#include <caterm/terminal/headless_backend.hpp>
+#include <caterm/terminal/terminal.hpp>
+#include <caterm/terminal/terminal_backend.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/layouts/vertical.hpp>
+#include <caterm/widget/point.hpp>
+#include <caterm/widget/widget.hpp>
+#include <caterm/widget/widgets/label.hpp>
+
+namespace {
+
+using Kind = ox::Headless_backend::Sgr_color::Kind;
+
+auto fg_sequence(ox::Color c) -> std::string_view
+{
+    static auto const sequences = [] {
+        auto result = std::array<std::string, 256>{};
+        for (auto i = 0; i < 256; ++i)
+            result[i] = "\033[38;5;" + std::to_string(i) + "m";
+        return result;
+    }();
+    return sequences[c.value];
+}
+
+auto bg_sequence(ox::Color c) -> std::string_view
+{
+    static auto const sequences = [] {
+        auto result = std::array<std::string, 256>{};
+        for (auto i = 0; i < 256; ++i)
+            result[i] = "\033[48;5;" + std::to_string(i) + "m";
+        return result;
+    }();
+    return sequences[c.value];
+}
+
+/// Makes \p backend the Terminal's backend until the end of the scope.
+/** The previous backend is restored, so no dangling pointer to a backend on
+ *  the stack is left behind for the next test. */
+class Backend_guard {
+   public:
+    explicit Backend_guard(ox::Terminal_backend& backend)
+        : previous_{ox::Terminal::backend()}
+    {
+        ox::Terminal::set_backend(backend);
+    }
+
+    Backend_guard(Backend_guard const&) = delete;
+    Backend_guard(Backend_guard&&)      = delete;
+    auto operator=(Backend_guard const&) -> Backend_guard& = delete;
+    auto operator=(Backend_guard&&) -> Backend_guard& = delete;
+
+    ~Backend_guard()
+    {
+        // Does nothing if the test already uninitialized the Terminal.
+        ox::Terminal::uninitialize();
+        ox::Terminal::set_backend(previous_);
+    }
+
+   private:
+    ox::Terminal_backend& previous_;
+};
+
+}  // namespace
+
+TEST_CASE("Headless_backend: Cursor movement and text", "[Headless_backend]")
+{
+    auto term = ox::Headless_backend{{10, 4}};
+    CHECK(term.write("hello\r\nworld") == 1);
+    CHECK(term.row(0) == U"hello     ");
+    CHECK(term.row(1) == U"world     ");
+    CHECK(term.cursor() == ox::Point{5, 1});
+
+    term.write("\033[3;8Hx\033[Ay\033[2D\033[Bz\033[H!");
+    CHECK(term.row(0) == U"!ello     ");
+    CHECK(term.row(1) == U"world   y ");
+    CHECK(term.row(2) == U"       z  ");
+
+    term.write("\033[?25l");
+    CHECK(!term.is_cursor_visible());
+    term.write("\033[?25h");
+    CHECK(term.is_cursor_visible());
+
+    term.write("\033[2J");
+    CHECK(term.row(0) == U"          ");
+    CHECK(term.bytes_written() > 0);
+    CHECK(term.write_count() == 5);
+}
+
+TEST_CASE("Headless_backend: Last column and scrolling", "[Headless_backend]")
+{
+    auto term = ox::Headless_backend{{4, 2}};
+    term.write("abcd");
+    CHECK(term.cursor() == ox::Point{3, 0});
+    term.write("ef");
+    CHECK(term.row(0) == U"abcd");
+    CHECK(term.row(1) == U"ef  ");
+    term.write("gh");
+    term.write("ij");
+    CHECK(term.row(0) == U"efgh");
+    CHECK(term.row(1) == U"ij  ");
+}
+
+TEST_CASE("Headless_backend: SGR and split sequences", "[Headless_backend]")
+{
+    std::setlocale(LC_ALL, "en_US.UTF-8");
+    auto term = ox::Headless_backend{{10, 2}};
+    term.write("\033[1;38;5;12");
+    term.write("m\xE2\x94");
+    term.write("\x80\033[48;2;1;2;3ma\033[22;39mb\033[0mc");
+
+    CHECK(term.at({0, 0}).symbol == U'─');
+    CHECK(term.at({0, 0}).attributes == (1u << 1));
+    CHECK(term.at({0, 0}).foreground.kind == Kind::Index);
+    CHECK(term.at({0, 0}).foreground.value == 12);
+    CHECK(term.at({1, 0}).background.kind == Kind::RGB);
+    CHECK(term.at({1, 0}).background.value == 0x010203);
+    CHECK(term.at({2, 0}).attributes == 0);
+    CHECK(term.at({2, 0}).foreground.kind == Kind::Default);
+    CHECK(term.at({2, 0}).background.kind == Kind::RGB);
+    CHECK(term.at({3, 0}).background.kind == Kind::Default);
+}
+
+TEST_CASE("Headless_backend: Decodes Frame_encoder output",
+          "[Headless_backend]")
+{
+    auto term    = ox::Headless_backend{{20, 5}};
+    auto encoder = ox::detail::Frame_encoder{&fg_sequence, &bg_sequence};
+    auto canvas  = ox::detail::Canvas{{20, 5}};
+    auto current = ox::detail::Canvas{{20, 5}};
+    canvas.at({3, 1}) = ox::Glyph{U'a', fg(ox::Color::Red)};
+    canvas.at({4, 1}) = ox::Glyph{U'b', bg(ox::Color::Blue)};
+    canvas.at({0, 4}) = ox::Glyph{U'c'};
+    canvas.at({19, 2}) = ox::Glyph{U'd'};
+
+    auto diff = ox::detail::Canvas::Diff{};
+    merge_and_diff(canvas, current, diff);
+    auto out = std::string{};
+    encoder.encode(diff, {20, 5}, out);
+    term.write(out);
+
+    CHECK(term.row(1) == U"   ab               ");
+    CHECK(term.row(2) == U"                   d");
+    CHECK(term.row(4) == U"c                   ");
+    CHECK(term.at({3, 1}).foreground.value == ox::Color::Red);
+    CHECK(term.at({4, 1}).background.value == ox::Color::Blue);
+}
+
+TEST_CASE("Headless_backend: Decodes REP, ECH and EL", "[Headless_backend]")
+{
+    auto term    = ox::Headless_backend{{20, 3}};
+    auto encoder = ox::detail::Frame_encoder{&fg_sequence, &bg_sequence};
+    encoder.set_capabilities(term.capabilities());
+    auto canvas  = ox::detail::Canvas{{20, 3}};
+    auto current = ox::detail::Canvas{{20, 3}};
+    for (auto x = 0; x < 20; ++x) {
+        canvas.at({x, 0}) = ox::Glyph{U'=', fg(ox::Color::Red)};
+        canvas.at({x, 1}) =
+            ox::Glyph{x < 12 ? U'x' : U' ', bg(ox::Color::Blue)};
+        canvas.at({x, 2}) = ox::Glyph{U' ', bg(ox::Color::Green)};
+    }
+    canvas.at({0, 2})  = ox::Glyph{U'>', bg(ox::Color::Green)};
+    canvas.at({19, 2}) = ox::Glyph{U'<', bg(ox::Color::Green)};
+
+    auto diff = ox::detail::Canvas::Diff{};
+    merge_and_diff(canvas, current, diff);
+    auto out = std::string{};
+    encoder.encode(diff, {20, 3}, out);
+    term.write(out);
+
+    auto literal = std::string{};
+    ox::detail::Frame_encoder{&fg_sequence, &bg_sequence}.encode(
+        diff, {20, 3}, literal);
+    CHECK(out.size() < literal.size());
+    CHECK(term.row(0) == U"====================");
+    CHECK(term.row(1) == U"xxxxxxxxxxxx        ");
+    CHECK(term.row(2) == U">                  <");
+    CHECK(term.at({19, 0}).foreground.value == ox::Color::Red);
+    CHECK(term.at({19, 1}).background.value == ox::Color::Blue);
+    CHECK(term.at({10, 2}).background.value == ox::Color::Green);
+}
+
+TEST_CASE("Headless_backend: Scroll regions", "[Headless_backend]")
+{
+    auto const area = ox::Area{8, 6};
+    auto term       = ox::Headless_backend{area};
+    auto encoder    = ox::detail::Frame_encoder{&fg_sequence, &bg_sequence};
+    auto next       = ox::detail::Canvas{area};
+    auto current    = ox::detail::Canvas{area};
+    auto diff       = ox::detail::Canvas::Diff{};
+    auto search     = ox::detail::Scroll_search{};
+    auto out        = std::string{};
+
+    // A log above a status line, starting from line number \p first.
+    auto const paint = [&](int first) {
+        for (auto y = 0; y < area.height; ++y) {
+            auto text = std::u32string{U"status  "};
+            if (y + 1 < area.height)
+                text = U"line " + std::u32string(1, U'0' + first + y) + U"  ";
+            for (auto x = 0; x < area.width; ++x)
+                next.at({x, y}) = ox::Glyph{text[x]};
+        }
+    };
+    paint(0);
+    merge_and_diff(next, current, diff);
+    encoder.encode(diff, area, out);
+    term.write(out);
+    next.reset();
+
+    paint(1);
+    auto const scroll = find_scroll(next, current, search);
+    REQUIRE(scroll.has_value());
+    CHECK(scroll->top == 0);
+    CHECK(scroll->bottom == 5);
+    CHECK(scroll->distance == 1);
+    out.clear();
+    encoder.scroll(*scroll, out);
+    apply_scroll(*scroll, next, current);
+    merge_and_diff(next, current, diff);
+    encoder.encode(diff, area, out);
+    term.write(out);
+
+    CHECK(diff.size() == 8);
+    CHECK(term.row(0) == U"line 1  ");
+    CHECK(term.row(3) == U"line 4  ");
+    CHECK(term.row(4) == U"line 5  ");
+    CHECK(term.row(5) == U"status  ");
+
+    // Reverse index at the top margin only scrolls down the region.
+    term.write("\033[1;3r\033M\033[r\033[6;1Hstatus 2");
+    CHECK(term.row(0) == U"        ");
+    CHECK(term.row(1) == U"line 1  ");
+    CHECK(term.row(2) == U"line 2  ");
+    CHECK(term.row(3) == U"line 4  ");
+    CHECK(term.row(5) == U"status 2");
+}
+
+TEST_CASE("Headless_backend: Scripted input", "[Headless_backend]")
+{
+    auto term = ox::Headless_backend{{10, 2}};
+    term.push_input(::esc::Key_press{ox::Key::Enter});
+    term.resize({5, 5});
+    CHECK(term.area() == ox::Area{5, 5});
+
+    auto first = term.read();
+    REQUIRE(first.has_value());
+    CHECK(std::holds_alternative<::esc::Key_press>(*first));
+    auto second = term.read();
+    REQUIRE(second.has_value());
+    REQUIRE(std::holds_alternative<::esc::Window_resize>(*second));
+    CHECK(std::get<::esc::Window_resize>(*second).new_dimensions ==
+          ox::Area{5, 5});
+    CHECK(!term.read().has_value());
+}
+
+TEST_CASE("Headless_backend: Runs a widget tree", "[Headless_backend]")
+{
+    auto term = ox::Headless_backend{{20, 4}};
+    auto const guard = Backend_guard{term};
+    ox::Terminal::initialize();
+
+    auto head = ox::layout::Vertical<ox::HLabel>{};
+    head.make_child(U"Top");
+    head.make_child(U"Bottom");
+    term.resize({12, 2});
+
+    ox::System::set_head(&head);
+    CHECK(ox::System::run() == 0);
+    ox::System::set_head(nullptr);
+    ox::Terminal::uninitialize();
+
+    CHECK(term.row(0) == U"Top         ");
+    CHECK(term.row(1) == U"Bottom      ");
+    CHECK(term.write_count() > 0);
+}
+
+TEST_CASE("Headless_backend: Collapses a resize storm", "[Headless_backend]")
+{
+    struct Resize_counter : ox::Widget {
+        int count = 0;
+
+        auto resize_event(ox::Area new_size, ox::Area old_size) -> bool override
+        {
+            ++count;
+            return Widget::resize_event(new_size, old_size);
+        }
+    };
+
+    auto term = ox::Headless_backend{{20, 4}};
+    auto const guard = Backend_guard{term};
+    ox::Terminal::initialize();
+
+    auto head = Resize_counter{};
+    ox::System::set_head(&head);
+    for (auto width = 21; width < 60; ++width)
+        term.resize({width, 4 + width % 3});
+    term.resize({30, 6});
+
+    CHECK(ox::System::run() == 0);
+    ox::System::set_head(nullptr);
+    ox::Terminal::uninitialize();
+
+    // Once from set_head() and once for the newest dimensions.
+    CHECK(head.count == 2);
+    CHECK(head.area() == ox::Area{30, 6});
+    CHECK(ox::Terminal::screen_buffers.area() == ox::Area{30, 6});
+}
+
+TEST_CASE("Headless_backend: A filtered paint does not cover others",
+          "[Headless_backend]")
+{
+    struct Paint_swallower : ox::Widget {
+        auto paint_event_filter(ox::Widget&, ox::Painter&) -> bool override
+        {
+            return true;
+        }
+    };
+
+    auto term = ox::Headless_backend{{6, 2}};
+    auto const guard = Backend_guard{term};
+    ox::Terminal::initialize();
+
+    auto swallower = Paint_swallower{};
+    auto head      = ox::layout::Vertical<>{};
+    head.set_wallpaper(U'x');
+    auto& child = head.make_child();
+    child.set_wallpaper(U'#');
+    child.install_event_filter(swallower);
+
+    ox::System::set_head(&head);
+    CHECK(ox::System::run() == 0);
+    ox::System::set_head(nullptr);
+    ox::Terminal::uninitialize();
+
+    // Nothing paints the child's area, so what is under it has to.
+    CHECK(term.row(0) == U"xxxxxx");
+    CHECK(term.row(1) == U"xxxxxx");
+}
@@ -0,0 +1,110 @@
+#include <caterm/common/mpsc_queue.hpp>
+
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/system/event.hpp>
+#include <caterm/system/event_queue.hpp>
+
+namespace {
+
+constexpr auto producer_count = 4;
+constexpr auto per_producer   = 5'000;
+constexpr auto total          = std::size_t{producer_count * per_producer};
+
+/// Return true if each producer's values were seen in the order pushed.
+auto in_producer_order(std::vector<std::pair<int, int>> const& seen) -> bool
+{
+    auto next = std::vector<int>(producer_count, 0);
+    for (auto const [producer, index] : seen) {
+        if (index != next[producer]++)
+            return false;
+    }
+    for (auto const n : next) {
+        if (n != per_producer)
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("Mpsc_queue: Single thread", "[Mpsc_queue]")
+{
+    auto q = ox::Mpsc_queue<int, 4>{};
+    CHECK(!q.try_pop().has_value());
+    for (auto i = 0; i < 4; ++i)
+        CHECK(q.try_push(int{i}));
+    CHECK(!q.try_push(4));
+
+    CHECK(q.try_pop() == 0);
+    CHECK(q.try_push(4));
+    for (auto i = 1; i < 5; ++i)
+        CHECK(q.try_pop() == i);
+    CHECK(!q.try_pop().has_value());
+}
+
+TEST_CASE("Mpsc_queue: Many producers", "[Mpsc_queue]")
+{
+    auto q         = ox::Mpsc_queue<std::pair<int, int>, 64>{};
+    auto producers = std::vector<std::thread>{};
+    for (auto p = 0; p < producer_count; ++p) {
+        producers.emplace_back([&q, p] {
+            for (auto i = 0; i < per_producer; ++i) {
+                while (!q.try_push({p, i}))
+                    std::this_thread::yield();
+            }
+        });
+    }
+    auto seen = std::vector<std::pair<int, int>>{};
+    while (seen.size() < total) {
+        if (auto value = q.try_pop(); value.has_value())
+            seen.push_back(*value);
+    }
+    for (auto& t : producers)
+        t.join();
+    CHECK(in_producer_order(seen));
+    CHECK(!q.try_pop().has_value());
+}
+
+TEST_CASE("Inbox: Spills over without reordering", "[Mpsc_queue]")
+{
+    auto inbox     = ox::detail::Inbox{};
+    auto seen      = std::vector<std::pair<int, int>>{};
+    auto producers = std::vector<std::thread>{};
+    for (auto p = 0; p < producer_count; ++p) {
+        producers.emplace_back([&inbox, &seen, p] {
+            for (auto i = 0; i < per_producer; ++i) {
+                auto const record = [&seen, p, i] { seen.push_back({p, i}); };
+                inbox.append(ox::Custom_event{record});
+            }
+        });
+    }
+    auto const take = [&inbox] {
+        inbox.take_all(
+            [](ox::Event e) { std::get<ox::Custom_event>(e).send(); });
+    };
+    // The consumer is slower than the producers, so the ring fills up.
+    while (seen.size() < total / 2)
+        take();
+    for (auto& t : producers)
+        t.join();
+    take();
+    CHECK(in_producer_order(seen));
+}
+
+TEST_CASE("Inbox: Wakes once per take_all", "[Mpsc_queue]")
+{
+    auto inbox = ox::detail::Inbox{};
+    CHECK(inbox.append(ox::Custom_event{[] {}}));
+    CHECK(!inbox.append(ox::Custom_event{[] {}}));
+    auto count = 0;
+    inbox.take_all([&count](ox::Event) { ++count; });
+    CHECK(count == 2);
+    CHECK(inbox.append(ox::Custom_event{[] {}}));
+}
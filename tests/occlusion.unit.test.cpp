@@ -0,0 +1,57 @@
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/painter/detail/occlusion.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+namespace {
+
+/// Return the uncovered runs of the rectangle at \p p with size \p a.
+auto uncovered(ox::detail::Occlusion const& o, ox::Point p, ox::Area a)
+    -> std::vector<ox::detail::Run>
+{
+    auto runs = std::vector<ox::detail::Run>{};
+    o.uncovered(p, a, runs);
+    return runs;
+}
+
+}  // namespace
+
+TEST_CASE("Occlusion: Uncovered runs", "[Occlusion]")
+{
+    auto o = ox::detail::Occlusion{};
+    o.reset({20, 4});
+
+    auto runs = uncovered(o, {0, 0}, {20, 1});
+    REQUIRE(runs.size() == 1);
+    CHECK(runs[0].at == ox::Point{0, 0});
+    CHECK(runs[0].width == 20);
+
+    o.cover({5, 0}, {3, 2});
+    o.cover({10, 0}, {2, 1});
+    runs = uncovered(o, {0, 0}, {20, 1});
+    REQUIRE(runs.size() == 3);
+    CHECK(runs[1].at == ox::Point{8, 0});
+    CHECK(runs[1].width == 2);
+    CHECK(runs[2].at == ox::Point{12, 0});
+    CHECK(runs[2].width == 8);
+
+    // Touching spans are merged, the gap between them is closed.
+    o.cover({8, 0}, {2, 1});
+    runs = uncovered(o, {0, 0}, {20, 1});
+    REQUIRE(runs.size() == 2);
+    CHECK(runs[1].at == ox::Point{12, 0});
+
+    // Cells outside of the screen are ignored, and are never visible.
+    o.cover({-3, 3}, {30, 5});
+    CHECK(uncovered(o, {0, 3}, {20, 9}).empty());
+    CHECK(uncovered(o, {6, 1}, {1, 1}).empty());
+
+    o.cover({0, 0}, {20, 4});
+    CHECK(uncovered(o, {0, 0}, {20, 4}).empty());
+
+    o.reset({20, 4});
+    CHECK(uncovered(o, {0, 0}, {20, 4}).size() == 4);
+}
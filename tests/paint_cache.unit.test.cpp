@@ -0,0 +1,61 @@
+#include <catch2/catch.hpp>
+
+#include <caterm/painter/detail/paint_cache.hpp>
+#include <caterm/painter/glyph.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+
+TEST_CASE("Paint_cache: Render and blit", "[Paint_cache]")
+{
+    auto const before = ox::detail::Paint_cache::total_stats();
+    auto cache        = ox::detail::Paint_cache{};
+    auto canvas       = ox::detail::Canvas{{10, 4}};
+    auto const area   = ox::Area{3, 2};
+
+    CHECK(!cache.blit({0, 0}, area, canvas));
+
+    // Cells left untouched by render keep what was underneath them.
+    canvas.at({3, 2}) = ox::Glyph{U'u'};
+    cache.render({2, 1}, area, canvas, [&] {
+        canvas.at({2, 1}) = ox::Glyph{U'a'};
+        canvas.at({4, 1}) = ox::Glyph{U'b'};
+        canvas.at({2, 2}) = ox::Glyph{U'c'};
+    });
+    CHECK(canvas.at({3, 1}) == ox::Glyph{});
+    CHECK(canvas.at({3, 2}) == ox::Glyph{U'u'});
+
+    // Moved, and only the cells it painted are put back.
+    canvas = ox::detail::Canvas{{10, 4}};
+    canvas.at({6, 3}) = ox::Glyph{U'v'};
+    REQUIRE(cache.blit({5, 2}, area, canvas));
+    CHECK(canvas.at({5, 2}) == ox::Glyph{U'a'});
+    CHECK(canvas.at({7, 2}) == ox::Glyph{U'b'});
+    CHECK(canvas.at({5, 3}) == ox::Glyph{U'c'});
+    CHECK(canvas.at({6, 3}) == ox::Glyph{U'v'});
+
+    // Cells off of the Canvas are dropped.
+    REQUIRE(cache.blit({8, 3}, area, canvas));
+    CHECK(canvas.at({8, 3}) == ox::Glyph{U'a'});
+
+    // Rendered partly off of the Canvas, the rest was never cached.
+    cache.render({8, 3}, area, canvas, [&] {
+        canvas.at({8, 3}) = ox::Glyph{U'd'};
+        canvas.at({9, 3}) = ox::Glyph{U'e'};
+    });
+    CHECK(cache.blit({9, 3}, area, canvas));
+    CHECK(!cache.blit({0, 0}, area, canvas));
+    cache.render({0, 0}, area, canvas, [&] {
+        canvas.at({2, 1}) = ox::Glyph{U'f'};
+    });
+    REQUIRE(cache.blit({1, 1}, area, canvas));
+    CHECK(canvas.at({3, 2}) == ox::Glyph{U'f'});
+
+    CHECK(!cache.blit({5, 2}, {3, 3}, canvas));
+    cache.invalidate();
+    CHECK(!cache.blit({5, 2}, area, canvas));
+
+    auto const after = ox::detail::Paint_cache::total_stats();
+    CHECK(after.hits - before.hits == 4);
+    CHECK(after.misses - before.misses == 3);
+}
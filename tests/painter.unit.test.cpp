@@ -0,0 +1,53 @@
+#include <utility>
+
+#include <catch2/catch.hpp>
+
+#include <caterm/painter/glyph.hpp>
+#include <caterm/painter/glyph_string.hpp>
+#include <caterm/painter/painter.hpp>
+#include <caterm/system/event.hpp>
+#include <caterm/system/system.hpp>
+#include <caterm/terminal/detail/canvas.hpp>
+#include <caterm/widget/area.hpp>
+#include <caterm/widget/point.hpp>
+#include <caterm/widget/widget.hpp>
+
+namespace {
+
+struct Placed_widget : ox::Widget {
+    // The base class handlers would post a Paint_event to the System.
+    auto move_event(ox::Point, ox::Point) -> bool override { return true; }
+
+    auto resize_event(ox::Area, ox::Area) -> bool override { return true; }
+};
+
+}  // namespace
+
+TEST_CASE("Painter: Clipped to the Canvas", "[Painter]")
+{
+    // Covers columns [3, 11) and rows [1, 5), past both edges of the Canvas.
+    auto w = Placed_widget{};
+    ox::System::send_event(ox::Move_event{w, {3, 1}});
+    ox::System::send_event(ox::Resize_event{w, {8, 4}});
+    auto canvas = ox::detail::Canvas{{6, 3}};
+    {
+        auto p = ox::Painter{w, canvas};
+        p.fill(ox::Glyph{U'#'}, {0, 0}, {8, 4});
+        p.put(ox::Glyph_string{U"cdef"}, {1, 0});
+        p.put(ox::Glyph{U'a'}, {2, 1});
+        p.put(ox::Glyph{U'b'}, {3, 0});
+        p.vline(ox::Glyph{U'|'}, {5, 0}, {5, 3});
+    }
+
+    auto const& c = std::as_const(canvas);
+    CHECK(c.dirty_span(0).begin >= c.dirty_span(0).end);
+    for (auto y = 1; y < 3; ++y) {
+        CHECK(c.dirty_span(y).begin == 3);
+        CHECK(c.dirty_span(y).end == 6);
+    }
+    CHECK(c.at({3, 1}).symbol == U'#');
+    CHECK(c.at({4, 1}).symbol == U'c');
+    CHECK(c.at({5, 1}).symbol == U'd');
+    CHECK(c.at({5, 2}).symbol == U'a');
+    CHECK(c.at({0, 2}) == ox::Glyph{});
+}